@@ -14,215 +14,1196 @@
  *     limitations under the License.
  */
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#include <setupapi.h>
-#include <conio.h>
-#include <devguid.h>
-#include <string>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Archive.h"
+#include "Bench.h"
 #include "BitStream.h"
+#include "Calls.h"
+#include "Dedup.h"
+#include "Capture.h"
+#include "Clock.h"
 #include "Decoder.h"
+#include "Feed.h"
+#include "Filter.h"
+#include "Generator.h"
+#include "Helpers.h"
+#include "Mapping.h"
+#include "Metrics.h"
+#include "Output.h"
+#include "Ring.h"
+#include "RingLog.h"
+#include "Site.h"
 
-#pragma comment(lib, "setupapi.lib")
+#ifdef _WIN32
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(linker, "/manifestdependency:\"type='win32' name='Microsoft.Windows.Common-Controls' version='6.0.0.0' processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
+#endif
 
-static void Capture(HANDLE hComPort)
-{
+typedef struct Port_t {
 	Decoder_t *pDecoder;
+	Archive_t *pArchive;
+	Ring_t *pInput;
+	uint8_t Index;
+	// Only set once there are several ports to tell apart
+	const char *pName;
+	int Metrics;
+} Port_t;
 
-	pDecoder = DECODER_New();
+// Renders events as text, JSON Lines or binary records. Lines go to the ring
+// log when there is one, else to the output ring when capturing, straight to
+// the log otherwise. With a feed, they are also published to local readers.
+// With a call tracker, call events are only shown once per call. With a
+// repeat window, repeated control channel events are only shown once per
+// window. With a site interval, each port gets a site model summarised on
+// stderr.
+typedef struct Printer_t {
+	EventFormat_t Format;
+	ClockText_t Clock;
+	Ring_t *pOutput;
+	Output_t *pLog;
+	RingLog_t *pRingLog;
+	Feed_t *pFeed;
+	Calls_t *pCalls;
+	Dedup_t *pDedup;
+	uint64_t SiteInterval;
+	uint64_t NextSite;
+	uint64_t LastRealtime;
+	SiteChannel_t *pSnapshot;
+	Site_t *pSites[256];
+	const char *pSiteNames[256];
+} Printer_t;
 
-	while (!_kbhit()) {
-		uint8_t Buffer[128];
-		DWORD bytesRead = 0;
+// Capture runs as three stages so neither decoding nor a slow console can
+// hold up the serial reads:
+//
+//   reader (CAPTURE_Run) -> Input ring -> decoder -> Output ring -> writer
+//
+// The reader never waits, chunks that do not fit in the input ring are
+// dropped and counted. The decoder waits for the writer so no decoded line
+// is lost, which pushes back on the input ring instead. The writer batches
+// the lines into a few large writes per second (Output.h).
+enum {
+	PIPELINE_INPUT_SIZE = 4 * 1024 * 1024,
+	PIPELINE_OUTPUT_SIZE = 4 * 1024 * 1024,
+	PIPELINE_WAIT_MS = 10,
+};
 
-		if (!ReadFile(hComPort, Buffer, sizeof(Buffer), &bytesRead, NULL)) {
-			DWORD error = GetLastError();
+enum {
+	RINGLOG_DEFAULT_MIB = 256,
+};
 
-			if (error != ERROR_IO_PENDING) {
-				printf("Error reading from COM port (%d)\n", error);
-				break;
-			}
+// Bumped by SIGHUP, each stage reopens its logs once it sees a new value
+static std::atomic<unsigned> gHangups;
+
+typedef struct Chunk_t {
+	uint64_t Timestamp;
+	size_t Port;
+} Chunk_t;
+
+typedef struct Pipeline_t {
+	// Turns the monotonic capture timestamps into wall clock time
+	uint64_t RealtimeOffset;
+	Printer_t Printer;
+	Port_t *pPorts;
+	Ring_t *pInput;
+	Ring_t *pOutput;
+	// Written by the decoder only, frames and lines alike
+	RingLog_t *pRingLog;
+	// The printer feed when frames are published too
+	Feed_t *pFrameFeed;
+	Metrics_t *pMetrics;
+} Pipeline_t;
+
+// Text lines start with the time, when known, and the port
+static size_t FormatPrefix(ClockText_t *pClock, char *pText, size_t TextLength, const EventSource_t *pSource)
+{
+	size_t Length = 0;
+
+	pText[0] = 0;
+	if (pSource->Realtime) {
+		Length = CLOCK_Format(pClock, pSource->Realtime, pText, TextLength);
+	}
+	if (pSource->pPort) {
+		int Tag = sprintf_s(pText + Length, TextLength - Length, "[%s] ", pSource->pPort);
+
+		if (Tag > 0 && (size_t)Tag < TextLength - Length) {
+			Length += (size_t)Tag;
 		}
+	}
 
-		if (bytesRead > 0) {
-			DECODER_AddBytes(pDecoder, Buffer, bytesRead);
-			while (DECODER_Check(pDecoder)) {
-				static char Text[64 + (ANYTONE_MAX_FRAME_LENGTH * 3)];
-				bool bSkip = false;
-
-				while (DECODER_GetFrameLength(pDecoder)) {
-					if (DECODER_GetText(pDecoder, bSkip, Text, sizeof(Text))) {
-						char Log[64];
-						struct tm TimeInfo;
-						time_t Now;
-
-						Now = time(nullptr);
-						localtime_s(&TimeInfo, &Now);
-						strftime(Log, sizeof(Log), "[%Y-%m-%d %H:%M:%S] ", &TimeInfo);
-						printf("%s%s\n", Log, Text);
-					}
-					bSkip = true;
-				}
+	return Length;
+}
+
+static void PrintEvent(Printer_t *pPrinter, const Event_t *pEvent, const EventSource_t *pSource)
+{
+	char Line[192 + (ANYTONE_MAX_FRAME_LENGTH * 3)];
+	size_t Length = 0;
+
+	switch (pPrinter->Format) {
+	case EVENT_TEXT:
+		Length = FormatPrefix(&pPrinter->Clock, Line, sizeof(Line), pSource);
+		if (EVENT_FormatText(pEvent, Line + Length, sizeof(Line) - Length - 1)) {
+			Length += strlen(Line + Length);
+			Line[Length++] = '\n';
+		} else {
+			Length = 0;
+		}
+		break;
+
+	case EVENT_JSON:
+		Length = EVENT_FormatJson(pEvent, pSource, Line, sizeof(Line));
+		break;
+
+	case EVENT_BINARY:
+		Length = EVENT_FormatBinary(pEvent, pSource, (uint8_t *)Line, sizeof(Line));
+		break;
+	}
+
+	if (Length) {
+		if (pPrinter->pRingLog) {
+			RINGLOG_Append(pPrinter->pRingLog, RINGLOG_LINE, pSource->Port, pSource->Realtime, Line, Length);
+		} else if (pPrinter->pOutput) {
+			RING_Push(pPrinter->pOutput, Line, Length);
+		} else {
+			OUTPUT_Write(pPrinter->pLog, Line, Length);
+		}
+		if (pPrinter->pFeed) {
+			FEED_Publish(pPrinter->pFeed, FEED_LINE, pSource->Port, pSource->Realtime, Line, Length);
+		}
+	}
+}
+
+static void OnCall(void *pContext, const Event_t *pCall, const EventSource_t *pSource)
+{
+	PrintEvent((Printer_t *)pContext, pCall, pSource);
+}
+
+static void OnRepeat(void *pContext, const Event_t *pSummary, const EventSource_t *pSource)
+{
+	PrintEvent((Printer_t *)pContext, pSummary, pSource);
+}
+
+// ALOHAs repeat on every idle slot, text only shows them once folded
+static bool IsShown(Printer_t *pPrinter, const Event_t *pEvent, const EventSource_t *pSource)
+{
+	if (pPrinter->pCalls && CALLS_Add(pPrinter->pCalls, pEvent, pSource)) {
+		return false;
+	}
+	if (pPrinter->pDedup) {
+		return !DEDUP_Add(pPrinter->pDedup, pEvent, pSource);
+	}
+
+	return pEvent->Type != EVENT_ALOHA || pPrinter->Format != EVENT_TEXT || (pEvent->Flags & EVENT_INCOMPLETE);
+}
+
+static void TrackSite(Printer_t *pPrinter, const Event_t *pEvent, const EventSource_t *pSource)
+{
+	Site_t **ppSite = &pPrinter->pSites[pSource->Port];
+
+	if (!*ppSite) {
+		*ppSite = SITE_New();
+		if (!*ppSite) {
+			return;
+		}
+		pPrinter->pSiteNames[pSource->Port] = pSource->pPort;
+	}
+	SITE_Add(*ppSite, pEvent, pSource->Realtime);
+}
+
+// Site summaries go to stderr with the statistics, away from the decoded lines
+static void PrintSites(Printer_t *pPrinter, uint64_t Now)
+{
+	char Line[256];
+	size_t i, j;
+
+	for (i = 0; i < 256; i++) {
+		const char *pName = pPrinter->pSiteNames[i];
+		size_t Count;
+
+		if (!pPrinter->pSites[i]) {
+			continue;
+		}
+		Count = SITE_Snapshot(pPrinter->pSites[i], Now, pPrinter->pSnapshot, SITE_MAX_LPCN);
+		SITE_FormatSite(pPrinter->pSites[i], pPrinter->pSnapshot, Count, Line, sizeof(Line));
+		fprintf(stderr, "%s%s%s%s\n", pName ? "[" : "", pName ? pName : "", pName ? "] " : "", Line);
+		for (j = 0; j < Count; j++) {
+			SITE_FormatChannel(&pPrinter->pSnapshot[j], Line, sizeof(Line));
+			fprintf(stderr, "%s\n", Line);
+		}
+	}
+}
+
+// Ends quiet calls and repeat windows, and prints the site summaries when due
+static void PollPrinter(Printer_t *pPrinter, uint64_t Now)
+{
+	if (!Now) {
+		return;
+	}
+	pPrinter->LastRealtime = Now;
+	if (pPrinter->pCalls) {
+		CALLS_Expire(pPrinter->pCalls, Now);
+	}
+	if (pPrinter->pDedup) {
+		DEDUP_Expire(pPrinter->pDedup, Now);
+	}
+	if (pPrinter->SiteInterval) {
+		if (!pPrinter->NextSite) {
+			pPrinter->NextSite = Now + pPrinter->SiteInterval;
+		} else if (Now >= pPrinter->NextSite) {
+			PrintSites(pPrinter, Now);
+			pPrinter->NextSite = Now + pPrinter->SiteInterval;
+		}
+	}
+}
+
+// Once the input is over, while port names are still valid
+static void FinishPrinter(Printer_t *pPrinter)
+{
+	if (pPrinter->pCalls) {
+		CALLS_Flush(pPrinter->pCalls);
+	}
+	if (pPrinter->pDedup) {
+		DedupStats_t Stats;
+
+		DEDUP_Flush(pPrinter->pDedup);
+		DEDUP_GetStats(pPrinter->pDedup, &Stats);
+		fprintf(stderr, "Repeats: %llu of %llu control events folded into %llu summaries, %llu evicted early\n",
+			(unsigned long long)Stats.Repeats,
+			(unsigned long long)Stats.Events,
+			(unsigned long long)Stats.Summaries,
+			(unsigned long long)Stats.Evictions);
+	}
+	if (pPrinter->SiteInterval) {
+		PrintSites(pPrinter, pPrinter->LastRealtime);
+	}
+}
+
+static void ClosePrinter(Printer_t *pPrinter)
+{
+	size_t i;
+
+	CALLS_Free(pPrinter->pCalls);
+	DEDUP_Free(pPrinter->pDedup);
+	for (i = 0; i < 256; i++) {
+		SITE_Free(pPrinter->pSites[i]);
+	}
+	free(pPrinter->pSnapshot);
+}
+
+static void PrintFrame(Printer_t *pPrinter, Decoder_t *pDecoder, const EventSource_t *pSource)
+{
+	bool bSkip = false;
+
+	PollPrinter(pPrinter, pSource->Realtime);
+
+	while (DECODER_GetFrameLength(pDecoder)) {
+		Event_t Event;
+
+		if (DECODER_GetEvent(pDecoder, bSkip, &Event)) {
+			if (pPrinter->SiteInterval) {
+				TrackSite(pPrinter, &Event, pSource);
+			}
+			if (IsShown(pPrinter, &Event, pSource)) {
+				PrintEvent(pPrinter, &Event, pSource);
 			}
 		}
+		bSkip = true;
+	}
+}
+
+static void PrintStats(Decoder_t *pDecoder, const char *pName)
+{
+	DecoderStats_t Stats;
+
+	DECODER_GetStats(pDecoder, &Stats);
+	fprintf(stderr, "%s: %llu bytes in, %llu frames, %llu dropped, %llu skipped in %llu resyncs, %llu bad lengths, %llu partial frames, %zu of %zu bytes buffered at most\n",
+		pName,
+		(unsigned long long)Stats.BytesIn,
+		(unsigned long long)Stats.Frames,
+		(unsigned long long)Stats.BytesDropped,
+		(unsigned long long)Stats.BytesSkipped,
+		(unsigned long long)Stats.Resyncs,
+		(unsigned long long)Stats.BadLengths,
+		(unsigned long long)Stats.PartialFrames,
+		Stats.HighWater,
+		Stats.BufferSize);
+}
 
-		Sleep(1);
+static void PrintOutputStats(Output_t *pLog)
+{
+	OutputStats_t Stats;
+
+	OUTPUT_GetStats(pLog, &Stats);
+	fprintf(stderr, "Log: %llu bytes in %llu writes, %llu failed\n",
+		(unsigned long long)Stats.Bytes,
+		(unsigned long long)Stats.Writes,
+		(unsigned long long)Stats.Errors);
+}
+
+static void PrintRingLogStats(RingLog_t *pRingLog)
+{
+	RingLogStats_t Stats;
+	double Hours = 0.0;
+
+	RINGLOG_GetStats(pRingLog, &Stats);
+	if (Stats.Oldest && Stats.Newest > Stats.Oldest) {
+		Hours = (double)(Stats.Newest - Stats.Oldest) / 3600e9;
 	}
+	fprintf(stderr, "Ring log: %llu records over %.1f hours in %llu bytes, %llu appended, %llu overwritten, %llu wraps, %llu syncs\n",
+		(unsigned long long)Stats.Records,
+		Hours,
+		(unsigned long long)Stats.Size,
+		(unsigned long long)Stats.Appended,
+		(unsigned long long)Stats.Overwritten,
+		(unsigned long long)Stats.Wraps,
+		(unsigned long long)Stats.Syncs);
 }
 
-static void ScanComPorts(void)
+static void PrintRingStats(Ring_t *pRing, const char *pName)
 {
-	SP_DEVINFO_DATA devData;
-	size_t Total = 0;
-	DWORD i;
+	RingStats_t Stats;
+
+	RING_GetStats(pRing, &Stats);
+	fprintf(stderr, "%s queue: %llu records, %llu dropped (%llu bytes), %zu of %zu bytes used at most\n",
+		pName,
+		(unsigned long long)Stats.Records,
+		(unsigned long long)Stats.Dropped,
+		(unsigned long long)Stats.DroppedBytes,
+		Stats.HighWater,
+		Stats.Size);
+}
 
-	// Get a list of all COM ports
-	HDEVINFO hDevInfo = SetupDiGetClassDevs(&GUID_DEVCLASS_PORTS, 0, 0, DIGCF_PRESENT);
-	if (hDevInfo == INVALID_HANDLE_VALUE) {
-		printf("Error: Failed to get device information.\n");
+// Signal handler of the daemon mode
+static void OnSignal(int Signal)
+{
+#ifdef SIGHUP
+	if (Signal == SIGHUP) {
+		gHangups++;
 		return;
 	}
+#endif
+	CAPTURE_Stop();
+}
+
+// Reader stage, called on the capture thread
+static void OnBytes(void *pContext, const uint8_t *pBytes, size_t Length, uint64_t Timestamp)
+{
+	Port_t *pPort = (Port_t *)pContext;
+	Chunk_t Chunk;
+	uint8_t *pRecord;
+
+	Chunk.Timestamp = Timestamp;
+	Chunk.Port = pPort->Index;
+
+	pRecord = (uint8_t *)RING_Reserve(pPort->pInput, sizeof(Chunk) + Length);
+	if (pRecord) {
+		memcpy(pRecord, &Chunk, sizeof(Chunk));
+		memcpy(pRecord + sizeof(Chunk), pBytes, Length);
+		RING_Commit(pPort->pInput);
+	}
+}
+
+static void DecodeStage(Pipeline_t *pPipeline)
+{
+	unsigned Hangups = gHangups;
 
-	devData.cbSize = sizeof(SP_DEVINFO_DATA);
+	while (!RING_IsDone(pPipeline->pInput)) {
+		const uint8_t *pRecord;
+		Port_t *pPort;
+		Chunk_t Chunk;
+		size_t Length;
 
-	// Enumerate all COM ports
-	for (i = 0; SetupDiEnumDeviceInfo(hDevInfo, i, &devData); i++) {
-		char friendlyName[256] = { 0 };
-		DWORD dataType = 0;
-		DWORD size = sizeof(friendlyName);
+		if (pPipeline->pRingLog) {
+			if (Hangups != gHangups) {
+				Hangups = gHangups;
+				if (!RINGLOG_Reopen(pPipeline->pRingLog)) {
+					fprintf(stderr, "Error: Failed to reopen the ring log.\n");
+				}
+			}
+			RINGLOG_Poll(pPipeline->pRingLog, CLOCK_GetMonotonic());
+		}
 
-		// Get the friendly name of the device
-		if (SetupDiGetDeviceRegistryProperty(hDevInfo, &devData, SPDRP_FRIENDLYNAME,
-			&dataType, (PBYTE)friendlyName, size, &size)) {
-			std::string portName = friendlyName;
-			size_t startPos = portName.find("(COM");
-			size_t endPos = portName.find(")", startPos);
+		pRecord = (const uint8_t *)RING_Peek(pPipeline->pInput, &Length, PIPELINE_WAIT_MS);
+		if (!pRecord) {
+			// Calls still end and sites still show once the radios fall silent
+			PollPrinter(&pPipeline->Printer, CLOCK_GetMonotonic() + pPipeline->RealtimeOffset);
+			continue;
+		}
+		memcpy(&Chunk, pRecord, sizeof(Chunk));
+		pPort = &pPipeline->pPorts[Chunk.Port];
 
-			if (startPos != std::string::npos && endPos != std::string::npos) {
-				std::string comPort = portName.substr(startPos + 1, endPos - startPos - 1);
-				printf("-> %s\n", comPort.c_str());
-				Total++;
+		// Frames are viewed in place, the record is only released afterwards
+		DECODER_Attach(pPort->pDecoder, pRecord + sizeof(Chunk), Length - sizeof(Chunk), Chunk.Timestamp);
+		while (DECODER_Check(pPort->pDecoder)) {
+			const uint64_t Timestamp = DECODER_GetTimestamp(pPort->pDecoder);
+			EventSource_t Source;
+
+			Source.Realtime = Timestamp + pPipeline->RealtimeOffset;
+			Source.Port = pPort->Index;
+			Source.pPort = pPort->pName;
+
+			if (pPort->pArchive || pPipeline->pRingLog || pPipeline->pFrameFeed) {
+				const uint8_t *pFrame;
+				size_t FrameLength;
+
+				pFrame = DECODER_GetFrame(pPort->pDecoder, &FrameLength);
+				if (pPort->pArchive) {
+					ARCHIVE_Write(pPort->pArchive, pPort->Index, Timestamp, pFrame, FrameLength);
+				}
+				if (pPipeline->pRingLog) {
+					RINGLOG_Append(pPipeline->pRingLog, RINGLOG_FRAME, pPort->Index, Source.Realtime, pFrame, FrameLength);
+				}
+				if (pPipeline->pFrameFeed) {
+					FEED_Publish(pPipeline->pFrameFeed, FEED_FRAME, pPort->Index, Source.Realtime, pFrame, FrameLength);
+				}
 			}
+
+			PrintFrame(&pPipeline->Printer, pPort->pDecoder, &Source);
+		}
+		RING_Release(pPipeline->pInput);
+
+		if (pPipeline->pMetrics) {
+			DecoderStats_t Stats;
+
+			DECODER_GetStats(pPort->pDecoder, &Stats);
+			METRICS_Publish(pPipeline->pMetrics, pPort->Metrics, &Stats);
 		}
 	}
 
-	SetupDiDestroyDeviceInfoList(hDevInfo);
+	FinishPrinter(&pPipeline->Printer);
+	RING_Close(pPipeline->pOutput);
+}
+
+static void WriteStage(Pipeline_t *pPipeline)
+{
+	unsigned Hangups = gHangups;
+
+	while (!RING_IsDone(pPipeline->pOutput)) {
+		const void *pLine;
+		size_t Length;
+
+		// Picks up a rotated -o file
+		if (Hangups != gHangups) {
+			Hangups = gHangups;
+			if (!OUTPUT_Reopen(pPipeline->Printer.pLog)) {
+				fprintf(stderr, "Error: Failed to reopen the log.\n");
+			}
+		}
 
-	if (!Total) {
-		printf("No COM ports found.\n");
+		pLine = RING_Peek(pPipeline->pOutput, &Length, PIPELINE_WAIT_MS);
+		if (pLine) {
+			OUTPUT_Write(pPipeline->Printer.pLog, pLine, Length);
+			RING_Release(pPipeline->pOutput);
+		}
+		// Full batches are written right away, the rest once they are due
+		OUTPUT_Poll(pPipeline->Printer.pLog, CLOCK_GetMonotonic());
 	}
+
+	OUTPUT_Flush(pPipeline->Printer.pLog);
 }
 
-static HANDLE StartCapture(const char *portName)
+static bool ReplayArchive(const char *pPath, uint64_t Start, bool bRaw, const Filter_t *pFilter, Printer_t *pPrinter)
 {
-	DCB dcb;
-	COMMTIMEOUTS timeouts;
-	HANDLE hComPort;
+	// Decoders keep per stream state such as the colour code, so each port
+	// recorded in the archive gets its own
+	static Decoder_t *pDecoders[256];
+	ArchiveReader_t *pReader;
+	ArchiveRecord_t Record;
+	size_t i;
 
-	// Open the COM port
-	std::string fullPortName = "\\\\.\\";
-	fullPortName += portName;
+	pReader = ARCHIVE_Open(pPath);
+	if (!pReader) {
+		fprintf(stderr, "Error: Failed to read archive %s.\n", pPath);
+		return false;
+	}
 
-	printf("Waiting for port...\n");
-	do {
-		hComPort = CreateFile(
-			fullPortName.c_str(),
-			GENERIC_READ,
-			0,
-			NULL,
-			OPEN_EXISTING,
-			FILE_ATTRIBUTE_NORMAL,
-			NULL);
-	} while (hComPort == INVALID_HANDLE_VALUE && !_kbhit());
+	if (Start && !ARCHIVE_Seek(pReader, Start)) {
+		fprintf(stderr, "Error: Archive ends before the requested time.\n");
+	}
 
-	if (hComPort == INVALID_HANDLE_VALUE) {
-		if (_kbhit()) {
-			printf("Exiting...\n");
-		} else {
-			DWORD error = GetLastError();
+	while (ARCHIVE_Next(pReader, &Record)) {
+		EventSource_t Source;
+		Decoder_t *pDecoder;
+
+		if (Record.Type != ARCHIVE_FRAME) {
+			continue;
+		}
+
+		if (!pDecoders[Record.Port]) {
+			pDecoders[Record.Port] = DECODER_New();
+			DECODER_SetRaw(pDecoders[Record.Port], bRaw);
+			DECODER_SetFilter(pDecoders[Record.Port], pFilter);
+		}
+		pDecoder = pDecoders[Record.Port];
+
+		Source.Port = Record.Port;
+		Source.pPort = NULL;
+		if (ARCHIVE_GetPortCount(pReader) > 1) {
+			Source.pPort = ARCHIVE_GetPortName(pReader, Record.Port);
+		}
 
-			printf("Error: Failed to open COM port (%d).\n", error);
+		DECODER_Attach(pDecoder, Record.pData, Record.Length, Record.Timestamp);
+		while (DECODER_Check(pDecoder)) {
+			Source.Realtime = ARCHIVE_ToRealtime(pReader, DECODER_GetTimestamp(pDecoder));
+			PrintFrame(pPrinter, pDecoder, &Source);
 		}
-		return hComPort;
 	}
+	// Port names belong to the reader
+	FinishPrinter(pPrinter);
 
-	printf("Configuring port...\n");
+	for (i = 0; i < 256; i++) {
+		if (pDecoders[i]) {
+			const char *pName = ARCHIVE_GetPortName(pReader, (uint8_t)i);
 
-	memset(&dcb, 0, sizeof(dcb));
-	dcb.DCBlength = sizeof(dcb);
+			PrintStats(pDecoders[i], pName[0] ? pName : pPath);
+			DECODER_Free(pDecoders[i]);
+			pDecoders[i] = NULL;
+		}
+	}
+	ARCHIVE_CloseReader(pReader);
+
+	return true;
+}
+
+// Decodes the frames kept in a ring log again, the stored lines are skipped
+static bool ReplayRingLog(const char *pPath, const Mapping_t *pMap, uint64_t Start, bool bRaw, const Filter_t *pFilter, Printer_t *pPrinter)
+{
+	static Decoder_t *pDecoders[256];
+	RingLogCursor_t Cursor;
+	RingLogRecord_t Record;
+	size_t i;
+
+	RINGLOG_Rewind(pMap->pData, &Cursor);
+	while (RINGLOG_Next(pMap->pData, pMap->Length, &Cursor, &Record)) {
+		EventSource_t Source;
+		Decoder_t *pDecoder;
+
+		if (Record.Type != RINGLOG_FRAME || Record.Realtime < Start) {
+			continue;
+		}
+
+		if (!pDecoders[Record.Port]) {
+			pDecoders[Record.Port] = DECODER_New();
+			DECODER_SetRaw(pDecoders[Record.Port], bRaw);
+			DECODER_SetFilter(pDecoders[Record.Port], pFilter);
+		}
+		pDecoder = pDecoders[Record.Port];
+
+		// Port names are not kept, the lines stored alongside have them
+		Source.Realtime = Record.Realtime;
+		Source.Port = Record.Port;
+		Source.pPort = NULL;
+
+		DECODER_Attach(pDecoder, Record.pData, Record.Length, Record.Realtime);
+		while (DECODER_Check(pDecoder)) {
+			PrintFrame(pPrinter, pDecoder, &Source);
+		}
+	}
+	FinishPrinter(pPrinter);
+
+	for (i = 0; i < 256; i++) {
+		if (pDecoders[i]) {
+			PrintStats(pDecoders[i], pPath);
+			DECODER_Free(pDecoders[i]);
+			pDecoders[i] = NULL;
+		}
+	}
+
+	return true;
+}
+
+static bool Replay(const char *pPath, uint64_t Start, bool bRaw, const Filter_t *pFilter, Printer_t *pPrinter)
+{
+	// Raw captures carry no time
+	const EventSource_t Source = { 0, 0, NULL };
+	Decoder_t *pDecoder;
+	Mapping_t Map;
+	uint64_t Begin;
+	double Seconds;
+	size_t Frames = 0;
+
+	if (!MAP_Open(&Map, pPath)) {
+		fprintf(stderr, "Error: Failed to open %s.\n", pPath);
+		return false;
+	}
+
+	if (ARCHIVE_IsArchive(Map.pData, Map.Length)) {
+		MAP_Close(&Map);
+		return ReplayArchive(pPath, Start, bRaw, pFilter, pPrinter);
+	}
+
+	if (RINGLOG_IsRingLog(Map.pData, Map.Length)) {
+		const bool bOk = ReplayRingLog(pPath, &Map, Start, bRaw, pFilter, pPrinter);
+
+		MAP_Close(&Map);
+		return bOk;
+	}
+
+	pDecoder = DECODER_New();
+	DECODER_SetRaw(pDecoder, bRaw);
+	DECODER_SetFilter(pDecoder, pFilter);
+
+	Begin = CLOCK_GetMonotonic();
+
+	DECODER_Attach(pDecoder, Map.pData, Map.Length, 0);
+	while (DECODER_Check(pDecoder)) {
+		PrintFrame(pPrinter, pDecoder, &Source);
+		Frames++;
+	}
+	FinishPrinter(pPrinter);
+	OUTPUT_Flush(pPrinter->pLog);
 
-	if (!GetCommState(hComPort, &dcb)) {
-		printf("Error: Failed to get COM port state.\n");
-		CloseHandle(hComPort);
-		return INVALID_HANDLE_VALUE;
+	Seconds = (double)(CLOCK_GetMonotonic() - Begin) / 1e9;
+	if (Seconds <= 0.0) {
+		Seconds = 1e-9;
 	}
 
-	dcb.BaudRate = CBR_115200;
-	dcb.ByteSize = 8;
-	dcb.Parity = NOPARITY;
-	dcb.StopBits = ONESTOPBIT;
+	// Keep the summary off stdout so the decoded text can be redirected
+	fprintf(stderr, "Replayed %zu bytes, %zu frames in %.3f s (%.1f MB/s, %.0f frames/s)\n",
+		Map.Length, Frames, Seconds, (double)Map.Length / Seconds / 1e6, (double)Frames / Seconds);
+	PrintStats(pDecoder, pPath);
+
+	DECODER_Free(pDecoder);
+	MAP_Close(&Map);
+
+	return true;
+}
+
+// Writes out the decoded lines kept in a ring log, oldest first
+static bool DumpRingLog(const char *pPath, Output_t *pLog)
+{
+	RingLogCursor_t Cursor;
+	RingLogRecord_t Record;
+	Mapping_t Map;
+	size_t Lines = 0;
+
+	if (!MAP_Open(&Map, pPath)) {
+		fprintf(stderr, "Error: Failed to open %s.\n", pPath);
+		return false;
+	}
+	if (!RINGLOG_IsRingLog(Map.pData, Map.Length)) {
+		fprintf(stderr, "Error: %s is not a ring log.\n", pPath);
+		MAP_Close(&Map);
+		return false;
+	}
+
+	RINGLOG_Rewind(Map.pData, &Cursor);
+	while (RINGLOG_Next(Map.pData, Map.Length, &Cursor, &Record)) {
+		if (Record.Type == RINGLOG_LINE) {
+			OUTPUT_Write(pLog, Record.pData, Record.Length);
+			Lines++;
+		}
+	}
+	OUTPUT_Flush(pLog);
+
+	fprintf(stderr, "Printed %zu lines from %s\n", Lines, pPath);
+	MAP_Close(&Map);
+
+	return true;
+}
+
+static std::atomic<bool> gbDetach;
+
+static void OnDetach(int Signal)
+{
+	(void)Signal;
+	gbDetach = true;
+}
+
+// Prints the lines a running capture publishes, until interrupted. Only this
+// process pays for the polling, the capture does not know it is there.
+static bool FollowFeed(const char *pName, Output_t *pLog)
+{
+	FeedReader_t *pReader;
+	FeedReaderStats_t Stats;
+	FeedRecord_t Record;
+	uint64_t Frames = 0;
+
+	pReader = FEED_Attach(pName);
+	if (!pReader) {
+		fprintf(stderr, "Error: No capture publishes %s.\n", pName);
+		return false;
+	}
+
+	signal(SIGINT, OnDetach);
+	signal(SIGTERM, OnDetach);
+
+	while (!gbDetach) {
+		if (!FEED_Next(pReader, &Record)) {
+			// Caught up, show what came and wait for more
+			OUTPUT_Flush(pLog);
+			std::this_thread::sleep_for(std::chrono::milliseconds(PIPELINE_WAIT_MS));
+			continue;
+		}
+		if (Record.Type == FEED_LINE) {
+			OUTPUT_Write(pLog, Record.pData, Record.Length);
+		} else {
+			Frames++;
+		}
+	}
+	OUTPUT_Flush(pLog);
+
+	FEED_GetReaderStats(pReader, &Stats);
+	fprintf(stderr, "Feed %s: %llu records, %llu frames skipped, %llu lost in %llu laps\n",
+		pName,
+		(unsigned long long)Stats.Records,
+		(unsigned long long)Frames,
+		(unsigned long long)Stats.Lost,
+		(unsigned long long)Stats.Laps);
+	FEED_Detach(pReader);
+
+	return true;
+}
+
+// Writes a raw byte capture of synthetic traffic, to replay with -r
+static bool WriteCapture(const char *pPath, const GeneratorMix_t *pMix)
+{
+	Generator_t *pGenerator;
+	uint8_t *pBuffer;
+	FILE *pFile;
+	size_t Length;
+	size_t Frames;
+	bool bOk;
+
+	pBuffer = (uint8_t *)malloc(GENERATOR_CAPTURE_BYTES);
+	pGenerator = GENERATOR_New(pMix, (uint32_t)CLOCK_GetRealtime());
+	if (!pBuffer || !pGenerator) {
+		free(pBuffer);
+		GENERATOR_Free(pGenerator);
+		fprintf(stderr, "Error: Out of memory.\n");
+		return false;
+	}
+	Length = GENERATOR_Fill(pGenerator, pBuffer, GENERATOR_CAPTURE_BYTES, &Frames);
+	GENERATOR_Free(pGenerator);
 
-	if (!SetCommState(hComPort, &dcb)) {
-		printf("Error: Failed to set COM port state.\n");
-		CloseHandle(hComPort);
-		return INVALID_HANDLE_VALUE;
+	if (fopen_s(&pFile, pPath, "wb") || !pFile) {
+		free(pBuffer);
+		fprintf(stderr, "Error: Failed to create %s.\n", pPath);
+		return false;
+	}
+	bOk = fwrite(pBuffer, 1, Length, pFile) == Length;
+	bOk = !fclose(pFile) && bOk;
+	free(pBuffer);
+	if (!bOk) {
+		fprintf(stderr, "Error: Failed to write %s.\n", pPath);
+		return false;
 	}
+	fprintf(stderr, "Wrote %zu frames in %zu bytes to %s\n", Frames, Length, pPath);
 
-	timeouts.ReadIntervalTimeout = 0;
-	timeouts.ReadTotalTimeoutConstant = 10;
-	timeouts.ReadTotalTimeoutMultiplier = 0;
-	timeouts.WriteTotalTimeoutConstant = 10;
-	timeouts.WriteTotalTimeoutMultiplier = 0;
+	return true;
+}
+
+static bool ParseTime(const char *pText, uint64_t *pRealtime)
+{
+	struct tm TimeInfo;
+	time_t Seconds;
 
-	if (!SetCommTimeouts(hComPort, &timeouts)) {
-		printf("Error: Failed to set COM port timeouts.\n");
-		CloseHandle(hComPort);
-		return INVALID_HANDLE_VALUE;
+	memset(&TimeInfo, 0, sizeof(TimeInfo));
+	if (sscanf_s(pText, "%d-%d-%d %d:%d", &TimeInfo.tm_year, &TimeInfo.tm_mon, &TimeInfo.tm_mday, &TimeInfo.tm_hour, &TimeInfo.tm_min) != 5) {
+		return false;
 	}
+	TimeInfo.tm_year -= 1900;
+	TimeInfo.tm_mon -= 1;
+	TimeInfo.tm_isdst = -1;
 
-	printf("Port initialised...\n");
+	Seconds = mktime(&TimeInfo);
+	if (Seconds == (time_t)-1) {
+		return false;
+	}
+	*pRealtime = (uint64_t)Seconds * 1000000000ULL;
 
-	return hComPort;
+	return true;
 }
 
-static void StopCapture(HANDLE hComPort)
+static bool ParseFormat(const char *pText, EventFormat_t *pFormat)
 {
-	// Close the COM port
-	if (hComPort != INVALID_HANDLE_VALUE) {
-		CloseHandle(hComPort);
-		hComPort = INVALID_HANDLE_VALUE;
+	if (!strcmp(pText, "text")) {
+		*pFormat = EVENT_TEXT;
+	} else if (!strcmp(pText, "json")) {
+		*pFormat = EVENT_JSON;
+	} else if (!strcmp(pText, "bin")) {
+		*pFormat = EVENT_BINARY;
+	} else {
+		return false;
 	}
 
-	printf("Stopped capturing data.\n");
+	return true;
+}
+
+static void Usage(const char *pName)
+{
+	printf("Usage:\n");
+	printf("    %s -l         List available COM ports.\n", pName);
+	printf("    %s -p COMx    Start capture on port COMx (ttyUSBx or ttyACMx on Linux).\n", pName);
+	printf("                  Repeat -p to capture several radios at once.\n");
+	printf("    %s -r file    Decode a raw byte capture or an archive as fast as possible.\n", pName);
+	printf("    %s -g file    Write a capture of synthetic traffic to replay with -r.\n", pName);
+	printf("    %s -b         Benchmark the decoder on synthetic traffic.\n", pName);
+	printf("    %s -z seconds Fuzz the framer and decoders with corrupted traffic, 0 for ever.\n", pName);
+	printf("    %s -L file    Print the decoded lines kept in a ring log.\n", pName);
+	printf("    %s -A name    Print the lines a capture publishes with -E name.\n", pName);
+	printf("\n");
+	printf("Options:\n");
+	printf("    -w file             Also store every frame in a timestamped archive.\n");
+	printf("    -R file             Keep the frames and decoded lines in a fixed size ring log\n");
+	printf("                        instead of writing the lines out. -r replays its frames.\n");
+	printf("    -S MiB              Size of a new -R ring log, %u by default.\n", RINGLOG_DEFAULT_MIB);
+	printf("    -E name             Publish the decoded lines in shared memory for -A and other\n");
+	printf("                        local readers.\n");
+	printf("    -e                  Publish the raw frames to the -E feed too.\n");
+	printf("    -d                  Run unattended: ignore the console, stop on SIGTERM or SIGINT,\n");
+	printf("                        sync and reopen the -o file and ring log on SIGHUP.\n");
+	printf("    -t \"YYYY-MM-DD HH:MM\"  Start replaying an archive at that local time.\n");
+	printf("    -o file             Write the decoded lines to a file instead of stdout.\n");
+	printf("    -P MiB              Reserve that much disk space for the -o file up front.\n");
+	printf("    -f text|json|bin    Output format, bin is described in Event.h.\n");
+	printf("    -x                  Also dump every command the decoders do not handle.\n");
+	printf("    -c                  Show each call once, when it ends, instead of its grants,\n");
+	printf("                        headers, aliases and terminator.\n");
+	printf("    -D seconds          Show repeated CACH and CSBK content once per window, with\n");
+	printf("                        a \"repeated xN\" summary when the window ends.\n");
+	printf("    -s seconds          Summarise the site, channel plan and busy timeslots on\n");
+	printf("                        stderr that often and at the end.\n");
+	printf("    -m port             Serve Prometheus metrics on http://127.0.0.1:port/metrics\n");
+	printf("                        while capturing.\n");
+	printf("    -M seconds          Print the decoder health on stderr that often while capturing.\n");
+	printf("    -G kind=weight,...  Traffic mix of -g, -b and -z. Kinds are csbk, voice, term, alias,\n");
+	printf("                        cach, cc, burst and cmd.\n");
+	printf("    -F [!]key=v,...     Only decode those values, or never with !. Keys are cmd,\n");
+	printf("                        type, opcode, fid, ts, cc and id. Repeat -F to combine.\n");
 }
 
 int main(int argc, char *argv[])
 {
-	HANDLE hComPort;
+	CapturePort_t CapturePorts[CAPTURE_MAX_PORTS];
+	Port_t Ports[CAPTURE_MAX_PORTS];
+	Pipeline_t Pipeline;
+	Printer_t Printer;
+	Archive_t *pArchive = NULL;
+	Filter_t *pFilter = NULL;
+	Output_t *pLog;
+	const char *pReplay = NULL;
+	const char *pArchiveName = NULL;
+	const char *pLogName = NULL;
+	const char *pCaptureName = NULL;
+	const char *pRingLogName = NULL;
+	const char *pDumpName = NULL;
+	RingLog_t *pRingLog = NULL;
+	const char *pFeedName = NULL;
+	const char *pFollowName = NULL;
+	Feed_t *pFeed = NULL;
+	bool bFeedFrames = false;
+	uint64_t RingLogSize = RINGLOG_DEFAULT_MIB * 1024ULL * 1024ULL;
+	bool bDaemon = false;
+	GeneratorMix_t Mix;
+	EventFormat_t Format = EVENT_TEXT;
+	uint64_t Preallocate = 0;
+	uint64_t SiteInterval = 0;
+	uint64_t MetricsInterval = 0;
+	unsigned long MetricsPort = 0;
+	uint64_t Start = 0;
+	bool bRaw = false;
+	bool bCalls = false;
+	uint64_t RepeatWindow = 0;
+	bool bBench = false;
+	bool bFuzz = false;
+	uint64_t FuzzSeconds = 0;
+	bool bOk;
+	size_t Count = 0;
+	size_t j;
+	int i;
 
-	printf("AnyTi3r v0.1  (c) Copyright 2026 Dual Tachyon\n\n");
+	// Keep stdout clean for JSON and binary streams
+	fprintf(stderr, "AnyTi3r v0.1  (c) Copyright 2026 Dual Tachyon\n\n");
+
+	GENERATOR_DefaultMix(&Mix);
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-l")) {
+			CAPTURE_ListPorts();
+			return 0;
+		} else if (!strcmp(argv[i], "-p") && i + 1 < argc && Count < CAPTURE_MAX_PORTS) {
+			CapturePorts[Count++].pName = argv[++i];
+		} else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+			pReplay = argv[++i];
+		} else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+			pCaptureName = argv[++i];
+		} else if (!strcmp(argv[i], "-b")) {
+			bBench = true;
+		} else if (!strcmp(argv[i], "-z") && i + 1 < argc) {
+			FuzzSeconds = strtoull(argv[++i], NULL, 10);
+			bFuzz = true;
+		} else if (!strcmp(argv[i], "-G") && i + 1 < argc && GENERATOR_ParseMix(argv[i + 1], &Mix)) {
+			i++;
+		} else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+			pArchiveName = argv[++i];
+		} else if (!strcmp(argv[i], "-R") && i + 1 < argc) {
+			pRingLogName = argv[++i];
+		} else if (!strcmp(argv[i], "-S") && i + 1 < argc) {
+			RingLogSize = strtoull(argv[++i], NULL, 10) * 1024 * 1024;
+		} else if (!strcmp(argv[i], "-L") && i + 1 < argc) {
+			pDumpName = argv[++i];
+		} else if (!strcmp(argv[i], "-d")) {
+			bDaemon = true;
+		} else if (!strcmp(argv[i], "-E") && i + 1 < argc) {
+			pFeedName = argv[++i];
+		} else if (!strcmp(argv[i], "-e")) {
+			bFeedFrames = true;
+		} else if (!strcmp(argv[i], "-A") && i + 1 < argc) {
+			pFollowName = argv[++i];
+		} else if (!strcmp(argv[i], "-t") && i + 1 < argc && ParseTime(argv[i + 1], &Start)) {
+			i++;
+		} else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+			pLogName = argv[++i];
+		} else if (!strcmp(argv[i], "-P") && i + 1 < argc) {
+			Preallocate = strtoull(argv[++i], NULL, 10) * 1024 * 1024;
+		} else if (!strcmp(argv[i], "-x")) {
+			bRaw = true;
+		} else if (!strcmp(argv[i], "-c")) {
+			bCalls = true;
+		} else if (!strcmp(argv[i], "-D") && i + 1 < argc) {
+			RepeatWindow = strtoull(argv[++i], NULL, 10) * 1000000000ULL;
+			if (!RepeatWindow) {
+				Usage(argv[0]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+			SiteInterval = strtoull(argv[++i], NULL, 10) * 1000000000ULL;
+			if (!SiteInterval) {
+				Usage(argv[0]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+			MetricsPort = strtoul(argv[++i], NULL, 10);
+			if (!MetricsPort || MetricsPort > 65535) {
+				Usage(argv[0]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-M") && i + 1 < argc) {
+			MetricsInterval = strtoull(argv[++i], NULL, 10) * 1000000000ULL;
+			if (!MetricsInterval) {
+				Usage(argv[0]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-F") && i + 1 < argc) {
+			if (!pFilter) {
+				pFilter = FILTER_New();
+			}
+			if (!pFilter || !FILTER_AddRule(pFilter, argv[++i])) {
+				Usage(argv[0]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-f") && i + 1 < argc && ParseFormat(argv[i + 1], &Format)) {
+			i++;
+		} else {
+			Usage(argv[0]);
+			return 1;
+		}
+	}
 
-	if (argc == 2 && strcmp(argv[1], "-l") == 0) {
-		ScanComPorts();
+	if (pCaptureName || bBench || bFuzz) {
+		if (pCaptureName && !WriteCapture(pCaptureName, &Mix)) {
+			return 1;
+		}
+		if ((bBench || bFuzz) && !BENCH_Check()) {
+			return 1;
+		}
+		if (bBench && !BENCH_Run(&Mix)) {
+			fprintf(stderr, "Error: Out of memory.\n");
+			return 1;
+		}
+		if (bFuzz && !BENCH_Fuzz(&Mix, FuzzSeconds)) {
+			return 1;
+		}
 		return 0;
 	}
 
-	if (argc != 3 || strcmp(argv[1], "-p")) {
-		printf("Usage:\n");
-		printf("    %s -l         List available COM ports.\n", argv[0]);
-		printf("    %s -p COMx    Start capture on port COMx.\n", argv[0]);
+	if (!pReplay && !Count && !pDumpName && !pFollowName) {
+		Usage(argv[0]);
+		return 1;
+	}
+
+	pLog = OUTPUT_Open(pLogName, Preallocate);
+	if (!pLog) {
+		fprintf(stderr, "Error: Failed to create %s.\n", pLogName ? pLogName : "stdout");
+		return 1;
+	}
+
+	if (pDumpName || pFollowName) {
+		bOk = pDumpName ? DumpRingLog(pDumpName, pLog) : FollowFeed(pFollowName, pLog);
+		OUTPUT_Close(pLog);
+		FILTER_Free(pFilter);
+		return bOk ? 0 : 1;
+	}
+
+	memset(&Printer, 0, sizeof(Printer));
+	Printer.Format = Format;
+	Printer.pLog = pLog;
+	Printer.SiteInterval = SiteInterval;
+	if (SiteInterval) {
+		Printer.pSnapshot = (SiteChannel_t *)malloc(SITE_MAX_LPCN * sizeof(SiteChannel_t));
+		if (!Printer.pSnapshot) {
+			fprintf(stderr, "Error: Out of memory.\n");
+			return 1;
+		}
+	}
+
+	if (pReplay) {
+		if (bCalls) {
+			Printer.pCalls = CALLS_New(OnCall, &Printer);
+			if (!Printer.pCalls) {
+				fprintf(stderr, "Error: Out of memory.\n");
+				return 1;
+			}
+		}
+		if (RepeatWindow) {
+			Printer.pDedup = DEDUP_New(RepeatWindow, OnRepeat, &Printer);
+			if (!Printer.pDedup) {
+				fprintf(stderr, "Error: Out of memory.\n");
+				return 1;
+			}
+		}
+		bOk = Replay(pReplay, Start, bRaw, pFilter, &Printer);
+		ClosePrinter(&Printer);
+		OUTPUT_Close(pLog);
+		FILTER_Free(pFilter);
+		return bOk ? 0 : 1;
+	}
+
+	if (pArchiveName) {
+		pArchive = ARCHIVE_Create(pArchiveName);
+		if (!pArchive) {
+			fprintf(stderr, "Error: Failed to create archive %s.\n", pArchiveName);
+			return 1;
+		}
+	}
+
+	// An existing ring log carries on where it stopped
+	if (pRingLogName) {
+		pRingLog = RINGLOG_Open(pRingLogName, RingLogSize);
+		if (!pRingLog) {
+			fprintf(stderr, "Error: Failed to open ring log %s.\n", pRingLogName);
+			return 1;
+		}
+	}
+
+	if (pFeedName) {
+		pFeed = FEED_Create(pFeedName, (uint32_t)Format);
+		if (!pFeed) {
+			fprintf(stderr, "Error: Failed to publish feed %s.\n", pFeedName);
+			return 1;
+		}
+	}
+
+	memset(&Pipeline, 0, sizeof(Pipeline));
+	Pipeline.RealtimeOffset = CLOCK_GetRealtime() - CLOCK_GetMonotonic();
+	Pipeline.pPorts = Ports;
+	Pipeline.pInput = RING_New(PIPELINE_INPUT_SIZE, RING_DROP);
+	Pipeline.pOutput = RING_New(PIPELINE_OUTPUT_SIZE, RING_BLOCK);
+	Pipeline.pRingLog = pRingLog;
+	Pipeline.Printer = Printer;
+	Pipeline.Printer.pOutput = Pipeline.pOutput;
+	Pipeline.Printer.pRingLog = pRingLog;
+	Pipeline.Printer.pFeed = pFeed;
+	if (bFeedFrames) {
+		Pipeline.pFrameFeed = pFeed;
+	}
+	if (bCalls) {
+		Pipeline.Printer.pCalls = CALLS_New(OnCall, &Pipeline.Printer);
+	}
+	if (RepeatWindow) {
+		Pipeline.Printer.pDedup = DEDUP_New(RepeatWindow, OnRepeat, &Pipeline.Printer);
+	}
+	if (MetricsPort || MetricsInterval) {
+		Pipeline.pMetrics = METRICS_New();
+	}
+	if (!Pipeline.pInput || !Pipeline.pOutput || (bCalls && !Pipeline.Printer.pCalls) || (RepeatWindow && !Pipeline.Printer.pDedup) || ((MetricsPort || MetricsInterval) && !Pipeline.pMetrics)) {
+		fprintf(stderr, "Error: Out of memory.\n");
 		return 1;
 	}
 
-	hComPort = StartCapture(argv[2]);
+	// One decoder per radio, lines are tagged with the port once there are several
+	for (j = 0; j < Count; j++) {
+		memset(&Ports[j], 0, sizeof(Ports[j]));
+		Ports[j].pDecoder = DECODER_New();
+		DECODER_SetRaw(Ports[j].pDecoder, bRaw);
+		DECODER_SetFilter(Ports[j].pDecoder, pFilter);
+		Ports[j].pArchive = pArchive;
+		Ports[j].pInput = Pipeline.pInput;
+		Ports[j].Index = (uint8_t)j;
+		Ports[j].Metrics = -1;
+		if (Pipeline.pMetrics) {
+			Ports[j].Metrics = METRICS_AddPort(Pipeline.pMetrics, CapturePorts[j].pName);
+		}
+		if (Count > 1) {
+			Ports[j].pName = CapturePorts[j].pName;
+		}
+		if (pArchive) {
+			ARCHIVE_AddPort(pArchive, Ports[j].Index, CapturePorts[j].pName);
+		}
+		CapturePorts[j].pContext = &Ports[j];
+	}
 
-	if (hComPort != INVALID_HANDLE_VALUE) {
-		Capture(hComPort);
-		StopCapture(hComPort);
+	if (Pipeline.pMetrics) {
+		METRICS_AddRing(Pipeline.pMetrics, Pipeline.pInput, "Input");
+		METRICS_AddRing(Pipeline.pMetrics, Pipeline.pOutput, "Output");
+		if (!METRICS_Start(Pipeline.pMetrics, (uint16_t)MetricsPort, MetricsInterval)) {
+			fprintf(stderr, "Error: Failed to serve metrics on port %lu.\n", MetricsPort);
+			return 1;
+		}
+	}
+
+	// Nothing but signals stops a daemon or reopens its logs
+	if (bDaemon) {
+		CAPTURE_SetConsole(false);
+		signal(SIGINT, OnSignal);
+		signal(SIGTERM, OnSignal);
+#ifdef SIGHUP
+		signal(SIGHUP, OnSignal);
+#endif
+#ifdef SIGPIPE
+		signal(SIGPIPE, SIG_IGN);
+#endif
+	}
+
+	std::thread Decoder(DecodeStage, &Pipeline);
+	std::thread Writer(WriteStage, &Pipeline);
+
+	CAPTURE_Run(CapturePorts, Count, OnBytes);
+
+	// Let the decoder and the writer drain what was already read
+	RING_Close(Pipeline.pInput);
+	Decoder.join();
+	Writer.join();
+	METRICS_Free(Pipeline.pMetrics);
+
+	if (pArchive) {
+		ARCHIVE_Close(pArchive);
+	}
+	if (pRingLog) {
+		PrintRingLogStats(pRingLog);
+		RINGLOG_Close(pRingLog);
+	}
+	FEED_Close(pFeed);
+	for (j = 0; j < Count; j++) {
+		PrintStats(Ports[j].pDecoder, CapturePorts[j].pName);
+		DECODER_Free(Ports[j].pDecoder);
 	}
+	PrintRingStats(Pipeline.pInput, "Input");
+	PrintRingStats(Pipeline.pOutput, "Output");
+	PrintOutputStats(pLog);
+	RING_Free(Pipeline.pInput);
+	RING_Free(Pipeline.pOutput);
+	ClosePrinter(&Pipeline.Printer);
+	OUTPUT_Close(pLog);
+	FILTER_Free(pFilter);
 
 	return 0;
 }
@@ -0,0 +1,407 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Archive.h"
+#include "Clock.h"
+#include "Helpers.h"
+#include "Mapping.h"
+#include "Platform.h"
+
+enum {
+	ARCHIVE_VERSION = 1,
+	ARCHIVE_HEADER_SIZE = 40,
+	ARCHIVE_RECORD_SIZE = 12,
+	ARCHIVE_INDEX_OFFSET = 24,
+	ARCHIVE_INDEX_INTERVAL = 60,
+	ARCHIVE_PORT_NAME = 32,
+};
+
+static const char kArchiveMagic[4] = { 'A', 'T', '3', 'A' };
+static const char kIndexMagic[4] = { 'A', 'T', '3', 'I' };
+
+typedef struct ArchiveIndex_t {
+	uint64_t Timestamp;
+	uint64_t Offset;
+} ArchiveIndex_t;
+
+struct Archive_t {
+	FILE *pFile;
+	uint64_t Offset;
+	ArchiveIndex_t *pIndex;
+	size_t IndexCount;
+	size_t IndexSize;
+};
+
+struct ArchiveReader_t {
+	Mapping_t Map;
+	uint64_t Realtime;
+	uint64_t Monotonic;
+	size_t Position;
+	size_t End;
+	ArchiveIndex_t *pIndex;
+	size_t IndexCount;
+	size_t IndexSize;
+	size_t PortCount;
+	char Ports[256][ARCHIVE_PORT_NAME];
+};
+
+// Private
+
+static bool AddIndex(ArchiveIndex_t **ppIndex, size_t *pCount, size_t *pSize, uint64_t Timestamp, uint64_t Offset)
+{
+	const size_t Count = *pCount;
+
+	if (Count && Timestamp < (*ppIndex)[Count - 1].Timestamp + ARCHIVE_INDEX_INTERVAL * 1000000000ULL) {
+		return true;
+	}
+
+	if (Count == *pSize) {
+		const size_t Size = Count ? Count * 2 : 256;
+		ArchiveIndex_t *pIndex = (ArchiveIndex_t *)realloc(*ppIndex, Size * sizeof(ArchiveIndex_t));
+
+		if (!pIndex) {
+			return false;
+		}
+		*ppIndex = pIndex;
+		*pSize = Size;
+	}
+
+	(*ppIndex)[Count].Timestamp = Timestamp;
+	(*ppIndex)[Count].Offset = Offset;
+	*pCount = Count + 1;
+
+	return true;
+}
+
+static bool WriteRecord(Archive_t *pArchive, uint8_t Type, uint8_t Port, uint64_t Timestamp, const void *pData, size_t Length)
+{
+	uint8_t Header[ARCHIVE_RECORD_SIZE];
+
+	if (Length > UINT16_MAX) {
+		return false;
+	}
+
+	PutU64(Header, Timestamp);
+	PutU16(Header + 8, (uint16_t)Length);
+	Header[10] = Port;
+	Header[11] = Type;
+
+	if (fwrite(Header, sizeof(Header), 1, pArchive->pFile) != 1) {
+		return false;
+	}
+	if (Length && fwrite(pData, Length, 1, pArchive->pFile) != 1) {
+		return false;
+	}
+
+	pArchive->Offset += sizeof(Header) + Length;
+
+	return true;
+}
+
+// Walks the records once when the archive was not closed cleanly
+static bool RebuildIndex(ArchiveReader_t *pReader)
+{
+	size_t Position = ARCHIVE_HEADER_SIZE;
+
+	while (Position + ARCHIVE_RECORD_SIZE <= pReader->Map.Length) {
+		const uint8_t *pRecord = pReader->Map.pData + Position;
+		const size_t Length = GetU16(pRecord + 8);
+
+		if (Position + ARCHIVE_RECORD_SIZE + Length > pReader->Map.Length) {
+			break;
+		}
+		if (!AddIndex(&pReader->pIndex, &pReader->IndexCount, &pReader->IndexSize, GetU64(pRecord), Position)) {
+			return false;
+		}
+		Position += ARCHIVE_RECORD_SIZE + Length;
+	}
+
+	// Drop a record torn by a crash
+	pReader->End = Position;
+
+	return true;
+}
+
+static bool LoadIndex(ArchiveReader_t *pReader, uint64_t Offset)
+{
+	const uint8_t *pIndex;
+	size_t Count;
+	size_t i;
+
+	if (!Offset || Offset < ARCHIVE_HEADER_SIZE || Offset + 8 > pReader->Map.Length) {
+		return false;
+	}
+
+	pIndex = pReader->Map.pData + Offset;
+	if (memcmp(pIndex, kIndexMagic, sizeof(kIndexMagic))) {
+		return false;
+	}
+
+	Count = GetU32(pIndex + 4);
+	if (Count > (pReader->Map.Length - Offset - 8) / 16) {
+		return false;
+	}
+
+	pReader->pIndex = (ArchiveIndex_t *)malloc((Count ? Count : 1) * sizeof(ArchiveIndex_t));
+	if (!pReader->pIndex) {
+		return false;
+	}
+
+	pIndex += 8;
+	for (i = 0; i < Count; i++) {
+		pReader->pIndex[i].Timestamp = GetU64(pIndex + (i * 16));
+		pReader->pIndex[i].Offset = GetU64(pIndex + (i * 16) + 8);
+		if (pReader->pIndex[i].Offset < ARCHIVE_HEADER_SIZE || pReader->pIndex[i].Offset > Offset) {
+			free(pReader->pIndex);
+			pReader->pIndex = NULL;
+			return false;
+		}
+	}
+	pReader->IndexCount = Count;
+	pReader->IndexSize = Count;
+	pReader->End = (size_t)Offset;
+
+	return true;
+}
+
+static bool PeekRecord(const ArchiveReader_t *pReader, size_t Position, ArchiveRecord_t *pRecord)
+{
+	const uint8_t *pHeader;
+
+	if (Position + ARCHIVE_RECORD_SIZE > pReader->End) {
+		return false;
+	}
+
+	pHeader = pReader->Map.pData + Position;
+	pRecord->Timestamp = GetU64(pHeader);
+	pRecord->Length = GetU16(pHeader + 8);
+	pRecord->Port = pHeader[10];
+	pRecord->Type = pHeader[11];
+	pRecord->pData = pHeader + ARCHIVE_RECORD_SIZE;
+
+	return Position + ARCHIVE_RECORD_SIZE + pRecord->Length <= pReader->End;
+}
+
+static void SetPortName(ArchiveReader_t *pReader, const ArchiveRecord_t *pRecord)
+{
+	size_t Length = pRecord->Length;
+
+	if (Length >= ARCHIVE_PORT_NAME) {
+		Length = ARCHIVE_PORT_NAME - 1;
+	}
+	if (!pReader->Ports[pRecord->Port][0]) {
+		pReader->PortCount++;
+	}
+	memcpy(pReader->Ports[pRecord->Port], pRecord->pData, Length);
+	pReader->Ports[pRecord->Port][Length] = 0;
+}
+
+// Public
+
+Archive_t *ARCHIVE_Create(const char *pPath)
+{
+	uint8_t Header[ARCHIVE_HEADER_SIZE];
+	Archive_t *pArchive;
+
+	pArchive = (Archive_t *)calloc(1, sizeof(Archive_t));
+	if (!pArchive) {
+		return NULL;
+	}
+
+	if (fopen_s(&pArchive->pFile, pPath, "wb") || !pArchive->pFile) {
+		free(pArchive);
+		return NULL;
+	}
+
+	// Large stdio buffer so a busy site costs a few writes per second
+	setvbuf(pArchive->pFile, NULL, _IOFBF, 1 << 20);
+
+	memset(Header, 0, sizeof(Header));
+	memcpy(Header, kArchiveMagic, sizeof(kArchiveMagic));
+	PutU16(Header + 4, ARCHIVE_VERSION);
+	PutU16(Header + 6, ARCHIVE_HEADER_SIZE);
+	PutU64(Header + 8, CLOCK_GetRealtime());
+	PutU64(Header + 16, CLOCK_GetMonotonic());
+	PutU32(Header + 32, ARCHIVE_INDEX_INTERVAL);
+
+	if (fwrite(Header, sizeof(Header), 1, pArchive->pFile) != 1) {
+		fclose(pArchive->pFile);
+		free(pArchive);
+		return NULL;
+	}
+	pArchive->Offset = sizeof(Header);
+
+	return pArchive;
+}
+
+bool ARCHIVE_AddPort(Archive_t *pArchive, uint8_t Port, const char *pName)
+{
+	return WriteRecord(pArchive, ARCHIVE_PORT, Port, CLOCK_GetMonotonic(), pName, strlen(pName));
+}
+
+bool ARCHIVE_Write(Archive_t *pArchive, uint8_t Port, uint64_t Timestamp, const uint8_t *pFrame, size_t Length)
+{
+	if (!AddIndex(&pArchive->pIndex, &pArchive->IndexCount, &pArchive->IndexSize, Timestamp, pArchive->Offset)) {
+		return false;
+	}
+
+	return WriteRecord(pArchive, ARCHIVE_FRAME, Port, Timestamp, pFrame, Length);
+}
+
+void ARCHIVE_Close(Archive_t *pArchive)
+{
+	uint8_t Bytes[16];
+	const uint64_t Offset = pArchive->Offset;
+	bool bSuccess;
+	size_t i;
+
+	memcpy(Bytes, kIndexMagic, sizeof(kIndexMagic));
+	PutU32(Bytes + 4, (uint32_t)pArchive->IndexCount);
+	bSuccess = fwrite(Bytes, 8, 1, pArchive->pFile) == 1;
+
+	for (i = 0; bSuccess && i < pArchive->IndexCount; i++) {
+		PutU64(Bytes, pArchive->pIndex[i].Timestamp);
+		PutU64(Bytes + 8, pArchive->pIndex[i].Offset);
+		bSuccess = fwrite(Bytes, 16, 1, pArchive->pFile) == 1;
+	}
+
+	// Only point the header at an index that made it to disk
+	if (bSuccess && !fflush(pArchive->pFile) && !fseek(pArchive->pFile, ARCHIVE_INDEX_OFFSET, SEEK_SET)) {
+		PutU64(Bytes, Offset);
+		fwrite(Bytes, 8, 1, pArchive->pFile);
+	}
+
+	fclose(pArchive->pFile);
+	free(pArchive->pIndex);
+	free(pArchive);
+}
+
+bool ARCHIVE_IsArchive(const uint8_t *pData, size_t Length)
+{
+	return Length >= ARCHIVE_HEADER_SIZE && !memcmp(pData, kArchiveMagic, sizeof(kArchiveMagic));
+}
+
+ArchiveReader_t *ARCHIVE_Open(const char *pPath)
+{
+	ArchiveReader_t *pReader;
+	ArchiveRecord_t Record;
+	const uint8_t *pHeader;
+
+	pReader = (ArchiveReader_t *)calloc(1, sizeof(ArchiveReader_t));
+	if (!pReader) {
+		return NULL;
+	}
+
+	if (!MAP_Open(&pReader->Map, pPath)) {
+		free(pReader);
+		return NULL;
+	}
+
+	pHeader = pReader->Map.pData;
+	if (!ARCHIVE_IsArchive(pHeader, pReader->Map.Length) || GetU16(pHeader + 6) != ARCHIVE_HEADER_SIZE) {
+		ARCHIVE_CloseReader(pReader);
+		return NULL;
+	}
+
+	pReader->Realtime = GetU64(pHeader + 8);
+	pReader->Monotonic = GetU64(pHeader + 16);
+
+	if (!LoadIndex(pReader, GetU64(pHeader + ARCHIVE_INDEX_OFFSET)) && !RebuildIndex(pReader)) {
+		ARCHIVE_CloseReader(pReader);
+		return NULL;
+	}
+
+	// Port names are written up front, pick them up before any seek
+	pReader->Position = ARCHIVE_HEADER_SIZE;
+	while (PeekRecord(pReader, pReader->Position, &Record) && Record.Type == ARCHIVE_PORT) {
+		SetPortName(pReader, &Record);
+		pReader->Position += ARCHIVE_RECORD_SIZE + Record.Length;
+	}
+	pReader->Position = ARCHIVE_HEADER_SIZE;
+
+	return pReader;
+}
+
+bool ARCHIVE_Next(ArchiveReader_t *pReader, ArchiveRecord_t *pRecord)
+{
+	if (!PeekRecord(pReader, pReader->Position, pRecord)) {
+		return false;
+	}
+
+	if (pRecord->Type == ARCHIVE_PORT) {
+		SetPortName(pReader, pRecord);
+	}
+	pReader->Position += ARCHIVE_RECORD_SIZE + pRecord->Length;
+
+	return true;
+}
+
+bool ARCHIVE_Seek(ArchiveReader_t *pReader, uint64_t Realtime)
+{
+	ArchiveRecord_t Record;
+	uint64_t Target;
+	size_t Low = 0;
+	size_t High = pReader->IndexCount;
+
+	if (Realtime <= pReader->Realtime) {
+		pReader->Position = ARCHIVE_HEADER_SIZE;
+		return true;
+	}
+	Target = pReader->Monotonic + (Realtime - pReader->Realtime);
+
+	// Last index entry at or before the target, then walk at most one interval
+	while (Low < High) {
+		const size_t Middle = Low + ((High - Low) / 2);
+
+		if (pReader->pIndex[Middle].Timestamp <= Target) {
+			Low = Middle + 1;
+		} else {
+			High = Middle;
+		}
+	}
+
+	pReader->Position = Low ? (size_t)pReader->pIndex[Low - 1].Offset : (size_t)ARCHIVE_HEADER_SIZE;
+	while (PeekRecord(pReader, pReader->Position, &Record) && Record.Timestamp < Target) {
+		pReader->Position += ARCHIVE_RECORD_SIZE + Record.Length;
+	}
+
+	return pReader->Position < pReader->End;
+}
+
+uint64_t ARCHIVE_ToRealtime(const ArchiveReader_t *pReader, uint64_t Timestamp)
+{
+	return pReader->Realtime + (Timestamp - pReader->Monotonic);
+}
+
+size_t ARCHIVE_GetPortCount(const ArchiveReader_t *pReader)
+{
+	return pReader->PortCount;
+}
+
+const char *ARCHIVE_GetPortName(const ArchiveReader_t *pReader, uint8_t Port)
+{
+	return pReader->Ports[Port];
+}
+
+void ARCHIVE_CloseReader(ArchiveReader_t *pReader)
+{
+	MAP_Close(&pReader->Map);
+	free(pReader->pIndex);
+	free(pReader);
+}
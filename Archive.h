@@ -0,0 +1,65 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Capture container layout, all integers little endian:
+//
+//   Header   "AT3A", u16 Version, u16 HeaderSize, u64 RealtimeNs, u64 MonotonicNs,
+//            u64 IndexOffset, u32 IndexInterval (seconds), u32 Reserved
+//   Record   u64 TimestampNs (monotonic), u16 Length, u8 Port, u8 Type, Length bytes
+//   Index    "AT3I", u32 Count, Count x { u64 TimestampNs, u64 Offset }
+//
+// The index is appended when the archive is closed and IndexOffset is patched
+// in the header. An archive that was never closed has IndexOffset 0 and the
+// reader rebuilds the index with a single scan.
+
+enum {
+	ARCHIVE_FRAME = 0,
+	ARCHIVE_PORT = 1,
+};
+
+typedef struct Archive_t Archive_t;
+typedef struct ArchiveReader_t ArchiveReader_t;
+
+typedef struct ArchiveRecord_t {
+	uint64_t Timestamp;
+	const uint8_t *pData;
+	uint16_t Length;
+	uint8_t Port;
+	uint8_t Type;
+} ArchiveRecord_t;
+
+Archive_t *ARCHIVE_Create(const char *pPath);
+bool ARCHIVE_AddPort(Archive_t *pArchive, uint8_t Port, const char *pName);
+bool ARCHIVE_Write(Archive_t *pArchive, uint8_t Port, uint64_t Timestamp, const uint8_t *pFrame, size_t Length);
+void ARCHIVE_Close(Archive_t *pArchive);
+
+bool ARCHIVE_IsArchive(const uint8_t *pData, size_t Length);
+ArchiveReader_t *ARCHIVE_Open(const char *pPath);
+bool ARCHIVE_Next(ArchiveReader_t *pReader, ArchiveRecord_t *pRecord);
+bool ARCHIVE_Seek(ArchiveReader_t *pReader, uint64_t Realtime);
+uint64_t ARCHIVE_ToRealtime(const ArchiveReader_t *pReader, uint64_t Timestamp);
+size_t ARCHIVE_GetPortCount(const ArchiveReader_t *pReader);
+const char *ARCHIVE_GetPortName(const ArchiveReader_t *pReader, uint8_t Port);
+void ARCHIVE_CloseReader(ArchiveReader_t *pReader);
+
+#endif
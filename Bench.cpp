@@ -0,0 +1,870 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "BitStream.h"
+#include "Bench.h"
+#include "Clock.h"
+#include "Decoder.h"
+#include "Event.h"
+#include "Generator.h"
+#include "Helpers.h"
+
+// Runs once over the input, returns the frames or fields it went through
+typedef size_t (*BenchFunc_t)(const uint8_t *pBuffer, size_t Length);
+
+static const uint8_t kWidths[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16, 24, 32 };
+
+// The opcodes the decoders parse, then one they dump raw
+static const struct {
+	uint8_t Opcode;
+	const char *pName;
+} kOpcodes[] = {
+	{ 0x19, "ALOHA" },
+	{ 0x30, "PV_GRANT" },
+	{ 0x31, "TV_GRANT" },
+	{ 0x32, "BTV_GRANT" },
+	{ 0x1C, "AHOY" },
+	{ 0x20, "C_ACKD" },
+	{ 0x28, "C_BCAST" },
+	{ 0x2F, "P_PROTECT" },
+	{ 0x3E, "raw" },
+};
+
+// Bytes queued one call after another under each overflow policy, what
+// DECODER_AddBytes() must return for the last call and the bytes dropped
+// in all
+static const struct {
+	DecoderOverflow_t Policy;
+	size_t Size;
+	size_t Adds[3];
+	int Result;
+	uint64_t Dropped;
+} kOverflows[] = {
+	{ DECODER_GROW, 4096, { 3000, 3000 }, 0, 0 },
+	{ DECODER_GROW, DECODER_MAX_BUFFER_SIZE, { DECODER_MAX_BUFFER_SIZE - 100, 1000 }, 1, 900 },
+	{ DECODER_DROP_OLDEST, 4096, { 3000 }, 0, 0 },
+	{ DECODER_DROP_OLDEST, 4096, { 3000, 3000 }, 1, 1904 },
+	{ DECODER_DROP_OLDEST, 4096, { 3000, 5000 }, 1, 3000 + 904 },
+	{ DECODER_DROP_OLDEST, 4096, { 3000, 4096 }, 1, 3000 },
+	{ DECODER_DROP_OLDEST, 4096, { 5000 }, 1, 904 },
+	{ DECODER_DROP_NEWEST, 4096, { 3000, 3000 }, 1, 1904 },
+	{ DECODER_DROP_NEWEST, 4096, { 5000 }, 1, 904 },
+};
+
+// Talker aliases as the decoder hands them out, and how JSON must show them
+static const struct {
+	uint8_t Format;
+	const char *pText;
+	const char *pJson;
+} kAliases[] = {
+	{ 0, "Base 1", "Base 1" },
+	{ 1, "Zo\xEB \"1\"", "Zo\\u00eb \\\"1\\\"" },
+	{ 2, "Zo\xC3\xAB \xE6\x9D\xB1 \xF0\x9F\x93\xBB", "Zo\xC3\xAB \xE6\x9D\xB1 \xF0\x9F\x93\xBB" },
+	{ 2, "Cut \xE6\x9D", "Cut \\ufffd\\ufffd" },
+	{ 2, "Long \xC0\xAF", "Long \\ufffd\\ufffd" },
+	{ 2, "Half \xED\xA0\x80", "Half \\ufffd\\ufffd\\ufffd" },
+	{ 2, "Latin \xE9t\xE9", "Latin \\ufffdt\\ufffd" },
+	{ 3, "Zo\xC3\xAB \xEF\xBF\xBD", "Zo\xC3\xAB \xEF\xBF\xBD" },
+};
+
+enum {
+	BENCH_BITS_ROUNDS = 100000, // Random streams read by both readers
+	BENCH_BITS_READS = 8,       // Reads and skips per stream
+	BENCH_BITS_BYTES = 24,      // Largest stream they are made from
+};
+
+// Written by every measure so the compiler keeps the work
+static volatile uint64_t gSink;
+
+typedef enum FuzzError_t {
+	FUZZ_FLIP,     // A few bits flipped anywhere in the frame
+	FUZZ_TRUNCATE, // The frame stops short, as when the firmware restarts
+	FUZZ_GARBAGE,  // Random bytes before the frame, as a USB glitch leaves
+	FUZZ_MAGIC,    // A false magic whose length runs over the next frames
+	FUZZ_RANDOM,   // The frame replaced by random bytes
+	FUZZ_ERRORS,
+} FuzzError_t;
+
+// Intact frames by the hash of their bytes, the same frame may repeat
+typedef struct FuzzFrame_t {
+	uint64_t Hash;
+	uint32_t Count;
+} FuzzFrame_t;
+
+typedef struct Fuzz_t {
+	uint32_t State;
+	FuzzFrame_t *pIntact;
+	size_t Mask;
+	uint64_t Errors;
+	uint64_t Intact;
+	uint64_t Found;
+	uint64_t Bytes;
+	uint64_t DecodeNs;
+	double WorstNs;
+	bool bViolation;
+} Fuzz_t;
+
+// Private
+
+#define GEN_DOWN_SHIFT(x)	(8U - (x))
+#define GEN_MASK(x)		((1U << (x)) - 1U)
+
+// The byte at a time reader BitStream.cpp had before its word at a time fast
+// paths, kept as the reference they are checked against
+static uint8_t RefGetBits(BitStream_t *pBs, size_t Bits)
+{
+	size_t Index = pBs->Position / 8U;
+	const size_t BitPos = pBs->Position % 8U;
+	uint32_t Mask;
+	size_t DownShift;
+	size_t UpShift;
+	const size_t LeftCount = GEN_DOWN_SHIFT(BitPos);
+	uint8_t Value;
+
+	// Check if the bits are contained within a single byte
+	if (BitPos + Bits <= 8U) {
+		Mask = GEN_MASK(Bits);
+		DownShift = GEN_DOWN_SHIFT(BitPos) - Bits;
+
+		pBs->Position += Bits;
+
+		return (pBs->pStream[Index] >> DownShift) & Mask;
+	}
+
+	Mask = GEN_MASK(LeftCount);
+	DownShift = GEN_DOWN_SHIFT(BitPos) - LeftCount;
+	UpShift = Bits - LeftCount;
+
+	pBs->Position += LeftCount;
+	Bits -= LeftCount;
+
+	Value = (pBs->pStream[Index++] >> DownShift) & Mask;
+	Value <<= UpShift;
+
+	Mask = GEN_MASK(Bits);
+	DownShift = GEN_DOWN_SHIFT(Bits);
+	Value |= (pBs->pStream[Index] >> DownShift) & Mask;
+
+	pBs->Position += Bits;
+
+	return Value;
+}
+
+// The reference BS_PopBits(), most significant byte first, or BS_PopUInt()
+// with bLittle, least significant byte first
+static bool RefPopBits(BitStream_t *pBs, size_t Bits, uint8_t *pBytes, size_t Length, bool bLittle)
+{
+	const size_t Count = Bits & 7U;
+	size_t Index = bLittle ? (Bits - 1U) / 8U : 0;
+
+	if (!Bits || Bits > Length * 8U || pBs->Position + Bits > pBs->Length) {
+		return false;
+	}
+
+	memset(pBytes, 0, Length);
+	if (Count > 0U) {
+		pBytes[bLittle ? Index-- : Index++] = RefGetBits(pBs, Count);
+		Bits -= Count;
+	}
+	while (Bits > 0U) {
+		pBytes[bLittle ? Index-- : Index++] = RefGetBits(pBs, 8U);
+		Bits -= 8U;
+	}
+
+	return true;
+}
+
+static uint64_t GetBigEndian(const uint8_t *pBytes, size_t Length)
+{
+	uint64_t Value = 0;
+	size_t i;
+
+	for (i = 0; i < Length; i++) {
+		Value = (Value << 8) | pBytes[i];
+	}
+
+	return Value;
+}
+
+static uint32_t CheckRandom(uint32_t *pState)
+{
+	*pState ^= *pState << 13;
+	*pState ^= *pState >> 17;
+	*pState ^= *pState << 5;
+
+	return *pState;
+}
+
+// Compares one read of the fast paths with the reference, from the same
+// position of the same stream
+static bool CheckRead(size_t Kind, BitStream_t *pRef, BitStream_t *pBs, size_t Bits, size_t Length)
+{
+	uint8_t Expected[8];
+	uint8_t Value[8];
+	uint16_t Value16;
+	uint32_t Value32;
+	bool bRef;
+
+	switch (Kind) {
+	case 0:
+		bRef = RefPopBits(pRef, Bits, Expected, Length, false);
+		return bRef == BS_PopBits(pBs, Bits, Value, Length) && (!bRef || !memcmp(Expected, Value, Length));
+
+	case 1:
+		bRef = RefPopBits(pRef, Bits, Expected, Length, true);
+		return bRef == BS_PopUInt(pBs, Bits, Value, Length) && (!bRef || !memcmp(Expected, Value, Length));
+
+	case 2:
+		// Unchecked, so only where BS_Need() allows it
+		Bits = 1U + (Bits - 1U) % BS_MAX_EXTRACT;
+		bRef = RefPopBits(pRef, Bits, Expected, 8U, false);
+		if (bRef != BS_Need(pBs, Bits)) {
+			return false;
+		}
+		return !bRef || GetBigEndian(Expected, (Bits + 7U) / 8U) == BS_ExtractBits(pBs, Bits);
+
+	case 3:
+		bRef = RefPopBits(pRef, 16U, Expected, 2U, false);
+		return bRef == BS_PopU16(pBs, &Value16) && (!bRef || GetBigEndian(Expected, 2U) == Value16);
+
+	case 4:
+		bRef = RefPopBits(pRef, 32U, Expected, 4U, false);
+		return bRef == BS_PopU32(pBs, &Value32) && (!bRef || GetBigEndian(Expected, 4U) == Value32);
+
+	default:
+		bRef = pRef->Position + Bits <= pRef->Length;
+		if (bRef) {
+			pRef->Position += Bits;
+		}
+		return bRef == BS_SkipBits(pBs, Bits);
+	}
+}
+
+// Sequences of reads and skips of random widths from a random offset, so
+// the cache is used part way, refilled and skipped over. A quarter of them
+// end at or just past the end of streams whose last byte may be partial.
+// Each stream is exactly as long as its buffer, so that a sanitizer catches
+// any read past it.
+static bool CheckBits(void)
+{
+	uint32_t State = 0x2545F491;
+	size_t Round;
+
+	for (Round = 0; Round < BENCH_BITS_ROUNDS; Round++) {
+		const size_t Size = 1U + CheckRandom(&State) % BENCH_BITS_BYTES;
+		uint8_t *pStream = (uint8_t *)malloc(Size);
+		BitStream_t Ref;
+		BitStream_t Bs;
+		size_t Read;
+		size_t i;
+
+		if (!pStream) {
+			return false;
+		}
+		for (i = 0; i < Size; i++) {
+			pStream[i] = (uint8_t)CheckRandom(&State);
+		}
+		BS_Init(&Ref, pStream, Size);
+		BS_Shrink(&Ref, CheckRandom(&State) % 8U);
+		Ref.Position = CheckRandom(&State) % (Ref.Length + 1U);
+		Bs = Ref;
+
+		for (Read = 0; Read < BENCH_BITS_READS; Read++) {
+			const size_t Kind = CheckRandom(&State) % 6U;
+			const size_t Length = 1U + CheckRandom(&State) % 8U;
+			const size_t Position = Ref.Position;
+			const size_t Left = Ref.Length - Ref.Position;
+			size_t Bits = 1U + CheckRandom(&State) % 64U;
+
+			if (!(CheckRandom(&State) & 3U) && Left < 64U) {
+				Bits = Left + CheckRandom(&State) % 2U;
+				Bits = Bits ? Bits : 1U;
+			}
+			if (!CheckRead(Kind, &Ref, &Bs, Bits, Length) || Ref.Position != Bs.Position) {
+				printf("Error: Read kind %zu of %zu bits at bit %zu of %zu does not match the reference\n",
+					Kind, Bits, Position, Ref.Length);
+				free(pStream);
+				return false;
+			}
+		}
+		free(pStream);
+	}
+
+	return true;
+}
+
+// Only the last call of each case may drop, an earlier drop fails it
+static bool CheckOverflow(void)
+{
+	uint8_t *pBytes = (uint8_t *)calloc(1, DECODER_MAX_BUFFER_SIZE);
+	bool bOk = true;
+	size_t i;
+	size_t j;
+
+	if (!pBytes) {
+		return false;
+	}
+
+	for (i = 0; i < sizeof(kOverflows) / sizeof(kOverflows[0]); i++) {
+		Decoder_t *pDecoder = DECODER_New();
+		DecoderStats_t Stats;
+		int Result = 0;
+
+		if (!pDecoder || !DECODER_SetBuffer(pDecoder, kOverflows[i].Size, kOverflows[i].Policy)) {
+			DECODER_Free(pDecoder);
+			free(pBytes);
+			return false;
+		}
+		for (j = 0; j < 3 && kOverflows[i].Adds[j]; j++) {
+			if (Result > 0) {
+				Result = -1;
+				break;
+			}
+			Result = DECODER_AddBytes(pDecoder, pBytes, kOverflows[i].Adds[j], 0);
+		}
+		DECODER_GetStats(pDecoder, &Stats);
+		DECODER_Free(pDecoder);
+		if (Result != kOverflows[i].Result || Stats.BytesDropped != kOverflows[i].Dropped) {
+			printf("Error: Overflow case %zu returns %d after dropping %llu bytes, not %d after %llu\n",
+				i, Result, (unsigned long long)Stats.BytesDropped, kOverflows[i].Result, (unsigned long long)kOverflows[i].Dropped);
+			bOk = false;
+		}
+	}
+	free(pBytes);
+
+	return bOk;
+}
+
+static bool CheckAliases(void)
+{
+	const EventSource_t Source = { 0, 0, NULL };
+	bool bOk = true;
+	size_t i;
+
+	for (i = 0; i < sizeof(kAliases) / sizeof(kAliases[0]); i++) {
+		Event_t Event;
+		char Expected[128];
+		char Json[256];
+
+		memset(&Event, 0, sizeof(Event));
+		Event.Type = EVENT_TALKER_ALIAS;
+		Event.Alias.Format = kAliases[i].Format;
+		Event.Alias.pText = kAliases[i].pText;
+		Event.Alias.Length = strlen(kAliases[i].pText);
+		snprintf(Expected, sizeof(Expected), "\"alias\":\"%s\"", kAliases[i].pJson);
+		if (!EVENT_FormatJson(&Event, &Source, Json, sizeof(Json)) || !strstr(Json, Expected)) {
+			printf("Error: Format %u alias %zu renders as %s", kAliases[i].Format, i, Json);
+			bOk = false;
+		}
+	}
+
+	return bOk;
+}
+
+// A line holds whole UTF-8 characters and no raw control characters
+static bool IsJsonLine(const char *pJson, size_t Length)
+{
+	size_t i = 0;
+
+	if (!Length || pJson[Length - 1] != '\n') {
+		return false;
+	}
+	while (i < Length - 1) {
+		const size_t Count = UTF8_GetLength(pJson + i, Length - 1 - i);
+
+		if (!Count || (uint8_t)pJson[i] < 0x20) {
+			return false;
+		}
+		i += Count;
+	}
+
+	return true;
+}
+
+static size_t PopFields(const uint8_t *pBuffer, size_t Length)
+{
+	BitStream_t Bs;
+	uint64_t Sum = 0;
+	size_t Count = 0;
+
+	BS_Init(&Bs, pBuffer, Length);
+	for (;;) {
+		const size_t Bits = kWidths[Count % sizeof(kWidths)];
+		uint32_t Value;
+
+		if (!BS_PopUInt(&Bs, Bits, &Value, sizeof(Value))) {
+			break;
+		}
+		Sum += Value;
+		Count++;
+	}
+	gSink += Sum;
+
+	return Count;
+}
+
+// The way the decoders read, BS_Need() once per record of every width
+static size_t ExtractFields(const uint8_t *pBuffer, size_t Length)
+{
+	BitStream_t Bs;
+	uint64_t Sum = 0;
+	size_t Count = 0;
+	size_t Record = 0;
+	size_t i;
+
+	for (i = 0; i < sizeof(kWidths); i++) {
+		Record += kWidths[i];
+	}
+
+	BS_Init(&Bs, pBuffer, Length);
+	while (BS_Need(&Bs, Record)) {
+		for (i = 0; i < sizeof(kWidths); i++) {
+			Sum += BS_ExtractBits(&Bs, kWidths[i]);
+		}
+		Count += sizeof(kWidths);
+	}
+	gSink += Sum;
+
+	return Count;
+}
+
+// The byte at a time reader the fast paths replaced, as BS_PopUInt() was
+static size_t RefFields(const uint8_t *pBuffer, size_t Length)
+{
+	BitStream_t Bs;
+	uint64_t Sum = 0;
+	size_t Count = 0;
+
+	BS_Init(&Bs, pBuffer, Length);
+	for (;;) {
+		const size_t Bits = kWidths[Count % sizeof(kWidths)];
+		uint8_t Value[4];
+
+		if (!RefPopBits(&Bs, Bits, Value, sizeof(Value), true)) {
+			break;
+		}
+		Sum += GetU32(Value);
+		Count++;
+	}
+	gSink += Sum;
+
+	return Count;
+}
+
+static size_t Frame(const uint8_t *pBuffer, size_t Length)
+{
+	Decoder_t *pDecoder = DECODER_New();
+	size_t Frames = 0;
+
+	DECODER_Attach(pDecoder, pBuffer, Length, 0);
+	while (DECODER_Check(pDecoder)) {
+		Frames++;
+	}
+	DECODER_Free(pDecoder);
+
+	return Frames;
+}
+
+static size_t GetText(const uint8_t *pBuffer, size_t Length)
+{
+	Decoder_t *pDecoder = DECODER_New();
+	size_t Frames = 0;
+	char Text[512];
+
+	DECODER_Attach(pDecoder, pBuffer, Length, 0);
+	while (DECODER_Check(pDecoder)) {
+		bool bSkip = false;
+
+		while (DECODER_GetFrameLength(pDecoder)) {
+			if (DECODER_GetText(pDecoder, bSkip, Text, sizeof(Text))) {
+				gSink += (uint8_t)Text[0];
+			}
+			bSkip = true;
+		}
+		Frames++;
+	}
+	DECODER_Free(pDecoder);
+
+	return Frames;
+}
+
+// Every event rendered, the way a replay with -x goes from bytes to text
+static size_t ToText(const uint8_t *pBuffer, size_t Length)
+{
+	Decoder_t *pDecoder = DECODER_New();
+	DecoderStats_t Stats;
+	Event_t Event;
+	char Text[512];
+
+	DECODER_SetRaw(pDecoder, true);
+	DECODER_Attach(pDecoder, pBuffer, Length, 0);
+	while (DECODER_NextEvent(pDecoder, &Event)) {
+		gSink += EVENT_FormatText(&Event, Text, sizeof(Text));
+	}
+	DECODER_GetStats(pDecoder, &Stats);
+	DECODER_Free(pDecoder);
+
+	return (size_t)Stats.Frames;
+}
+
+// Repeats Func over the buffer for at least BENCH_MIN_MS
+static void Measure(const char *pName, const char *pUnit, BenchFunc_t Func, const uint8_t *pBuffer, size_t Length)
+{
+	const uint64_t Begin = CLOCK_GetMonotonic();
+	uint64_t Elapsed;
+	uint64_t Units = 0;
+	uint64_t Bytes = 0;
+
+	do {
+		Units += Func(pBuffer, Length);
+		Bytes += Length;
+		Elapsed = CLOCK_GetMonotonic() - Begin;
+	} while (Elapsed < BENCH_MIN_MS * 1000000ULL);
+
+	if (!Units || !Elapsed) {
+		return;
+	}
+	printf("%-24s %9.1f ns/%-6s %9.1f MB/s\n", pName, (double)Elapsed / (double)Units, pUnit, (double)Bytes * 1e3 / (double)Elapsed);
+}
+
+// Synthetic traffic of the given mix, or only CSBKs of one opcode
+static uint8_t *Generate(const GeneratorMix_t *pMix, int Opcode, size_t *pLength, size_t *pFrames)
+{
+	Generator_t *pGenerator;
+	uint8_t *pBuffer;
+
+	pBuffer = (uint8_t *)malloc(BENCH_BYTES);
+	pGenerator = GENERATOR_New(pMix, 1);
+	if (!pBuffer || !pGenerator) {
+		free(pBuffer);
+		GENERATOR_Free(pGenerator);
+		return NULL;
+	}
+	GENERATOR_SetOpcode(pGenerator, Opcode);
+	*pLength = GENERATOR_Fill(pGenerator, pBuffer, BENCH_BYTES, pFrames);
+	GENERATOR_Free(pGenerator);
+
+	return pBuffer;
+}
+
+static uint32_t FuzzRandom(Fuzz_t *pFuzz)
+{
+	uint32_t x = pFuzz->State;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	pFuzz->State = x;
+
+	return x;
+}
+
+static uint64_t Hash(const uint8_t *pBytes, size_t Length)
+{
+	uint64_t Hash = 0xCBF29CE484222325ULL;
+	size_t i;
+
+	for (i = 0; i < Length; i++) {
+		Hash = (Hash ^ pBytes[i]) * 0x100000001B3ULL;
+	}
+
+	return Hash | 1;
+}
+
+static FuzzFrame_t *FindIntact(Fuzz_t *pFuzz, uint64_t Hash)
+{
+	size_t Slot = (size_t)Hash & pFuzz->Mask;
+
+	while (pFuzz->pIntact[Slot].Hash && pFuzz->pIntact[Slot].Hash != Hash) {
+		Slot = (Slot + 1) & pFuzz->Mask;
+	}
+
+	return &pFuzz->pIntact[Slot];
+}
+
+static void FillRandom(Fuzz_t *pFuzz, uint8_t *pBytes, size_t Length)
+{
+	size_t i;
+
+	for (i = 0; i < Length; i++) {
+		pBytes[i] = (uint8_t)FuzzRandom(pFuzz);
+	}
+}
+
+// Generated frames with errors injected into some of them. Returns the
+// length of the stream, the frames left intact are remembered.
+static size_t BuildStream(Fuzz_t *pFuzz, Generator_t *pGenerator, uint8_t *pStream, size_t Size)
+{
+	static const uint8_t kMagic[3] = { 0x84, 0xA9, 0x61 };
+	size_t Length = 0;
+	size_t i;
+
+	for (i = 0; i < BENCH_FUZZ_FRAMES && Size - Length >= 2 * ANYTONE_MAX_FRAME_LENGTH; i++) {
+		uint8_t *pFrame = pStream + Length;
+		size_t FrameLength;
+		size_t Count;
+		bool bIntact = true;
+
+		if (FuzzRandom(pFuzz) % 100 >= BENCH_FUZZ_PERCENT) {
+			Length += GENERATOR_Frame(pGenerator, pFrame, Size - Length);
+		} else {
+			switch ((FuzzError_t)(FuzzRandom(pFuzz) % FUZZ_ERRORS)) {
+			case FUZZ_FLIP:
+				FrameLength = GENERATOR_Frame(pGenerator, pFrame, Size - Length);
+				for (Count = 1 + FuzzRandom(pFuzz) % 3; Count; Count--) {
+					const size_t Bit = FuzzRandom(pFuzz) % (FrameLength * 8);
+
+					pFrame[Bit / 8] ^= (uint8_t)(0x80 >> (Bit % 8));
+				}
+				Length += FrameLength;
+				bIntact = false;
+				break;
+			case FUZZ_TRUNCATE:
+				FrameLength = GENERATOR_Frame(pGenerator, pFrame, Size - Length);
+				Length += FuzzRandom(pFuzz) % FrameLength;
+				bIntact = false;
+				break;
+			case FUZZ_GARBAGE:
+				Count = 1 + FuzzRandom(pFuzz) % 64;
+				FillRandom(pFuzz, pFrame, Count);
+				Length += Count;
+				pFrame += Count;
+				Length += GENERATOR_Frame(pGenerator, pFrame, Size - Length);
+				break;
+			case FUZZ_MAGIC:
+				// Just under the longest length the framer accepts
+				Count = ANYTONE_MAX_FRAME_LENGTH - 6 - 2 * (FuzzRandom(pFuzz) % 16);
+				memcpy(pFrame, kMagic, sizeof(kMagic));
+				pFrame[3] = (uint8_t)(Count >> 8);
+				pFrame[4] = (uint8_t)Count;
+				Length += 5;
+				pFrame += 5;
+				Length += GENERATOR_Frame(pGenerator, pFrame, Size - Length);
+				break;
+			default:
+				FrameLength = GENERATOR_Frame(pGenerator, pFrame, Size - Length);
+				FillRandom(pFuzz, pFrame, FrameLength);
+				Length += FrameLength;
+				bIntact = false;
+				break;
+			}
+			pFuzz->Errors++;
+		}
+
+		if (bIntact) {
+			const uint64_t FrameHash = Hash(pFrame, (size_t)(pStream + Length - pFrame));
+			FuzzFrame_t *pIntact = FindIntact(pFuzz, FrameHash);
+
+			pIntact->Hash = FrameHash;
+			pIntact->Count++;
+			pFuzz->Intact++;
+		}
+	}
+
+	return Length;
+}
+
+// Decodes a frame again from a copy of exactly its length, so that reading
+// past it is caught by a sanitizer, and checks every event stays inside it
+// and renders as a valid JSON line
+static void CheckFrame(Fuzz_t *pFuzz, Decoder_t *pShadow, const uint8_t *pFrame, size_t FrameLength)
+{
+	const EventSource_t Source = { 0, 0, NULL };
+	uint8_t *pCopy = (uint8_t *)malloc(FrameLength);
+	Event_t Event;
+	char Text[512];
+	size_t Length;
+
+	if (!pCopy) {
+		return;
+	}
+	memcpy(pCopy, pFrame, FrameLength);
+	DECODER_Attach(pShadow, pCopy, FrameLength, 0);
+	while (DECODER_NextEvent(pShadow, &Event)) {
+		if (Event.pData && (Event.pData < pCopy || Event.pData + Event.Length > pCopy + FrameLength)) {
+			printf("Error: Event type %d points %td bytes into a %zu bytes frame, %zu bytes long\n",
+				(int)Event.Type, Event.pData - pCopy, FrameLength, Event.Length);
+			pFuzz->bViolation = true;
+			continue;
+		}
+		gSink += EVENT_FormatText(&Event, Text, sizeof(Text));
+		Length = EVENT_FormatJson(&Event, &Source, Text, sizeof(Text));
+		if (Length && !IsJsonLine(Text, Length)) {
+			printf("Error: Event type %d renders as invalid JSON: %.*s", (int)Event.Type, (int)Length, Text);
+			pFuzz->bViolation = true;
+		}
+	}
+	free(pCopy);
+}
+
+// Feeds the stream in chunks the way a capture does, timing each chunk
+static void DecodeStream(Fuzz_t *pFuzz, const uint8_t *pStream, size_t Length, DecoderStats_t *pStats)
+{
+	Decoder_t *pDecoder = DECODER_New();
+	Decoder_t *pShadow = DECODER_New();
+	size_t Offset;
+
+	DECODER_SetRaw(pDecoder, true);
+	DECODER_SetRaw(pShadow, true);
+
+	for (Offset = 0; Offset < Length; Offset += BENCH_FUZZ_CHUNK) {
+		const size_t Chunk = Length - Offset < BENCH_FUZZ_CHUNK ? Length - Offset : (size_t)BENCH_FUZZ_CHUNK;
+		uint64_t Elapsed = 0;
+		uint64_t Begin = CLOCK_GetMonotonic();
+		double Ns;
+
+		DECODER_Attach(pDecoder, pStream + Offset, Chunk, 0);
+		while (DECODER_Check(pDecoder)) {
+			const uint8_t *pFrame;
+			size_t FrameLength;
+			FuzzFrame_t *pIntact;
+			Event_t Event;
+			char Text[512];
+
+			pFrame = DECODER_GetFrame(pDecoder, &FrameLength);
+			while (DECODER_GetFrameLength(pDecoder)) {
+				if (DECODER_GetEvent(pDecoder, DECODER_GetFrameLength(pDecoder) != FrameLength, &Event)) {
+					gSink += EVENT_FormatText(&Event, Text, sizeof(Text));
+				}
+			}
+			Elapsed += CLOCK_GetMonotonic() - Begin;
+
+			// Bookkeeping is left out of the timing
+			pIntact = FindIntact(pFuzz, Hash(pFrame, FrameLength));
+			if (pIntact->Count) {
+				pIntact->Count--;
+				pFuzz->Found++;
+			}
+			CheckFrame(pFuzz, pShadow, pFrame, FrameLength);
+			Begin = CLOCK_GetMonotonic();
+		}
+		Elapsed += CLOCK_GetMonotonic() - Begin;
+
+		Ns = (double)Elapsed / (double)Chunk;
+		if (Ns > pFuzz->WorstNs) {
+			pFuzz->WorstNs = Ns;
+		}
+		pFuzz->DecodeNs += Elapsed;
+	}
+	pFuzz->Bytes += Length;
+
+	DECODER_GetStats(pDecoder, pStats);
+	DECODER_Free(pShadow);
+	DECODER_Free(pDecoder);
+}
+
+// Public
+
+bool BENCH_Check(void)
+{
+	return CheckOverflow() && CheckBits() && CheckAliases();
+}
+
+bool BENCH_Run(const GeneratorMix_t *pMix)
+{
+	GeneratorMix_t Csbks = { { 0 } };
+	uint8_t *pBuffer;
+	size_t Length;
+	size_t Frames;
+	size_t i;
+
+	pBuffer = Generate(pMix, -1, &Length, &Frames);
+	if (!pBuffer) {
+		return false;
+	}
+	printf("Synthetic traffic: %zu frames in %zu bytes\n\n", Frames, Length);
+
+	Measure("Byte-wise reference", "field", RefFields, pBuffer, Length);
+	Measure("BS_PopUInt", "field", PopFields, pBuffer, Length);
+	Measure("BS_ExtractBits", "field", ExtractFields, pBuffer, Length);
+	Measure("DECODER_Check", "frame", Frame, pBuffer, Length);
+	Measure("Bytes to text", "frame", ToText, pBuffer, Length);
+	free(pBuffer);
+
+	printf("\nDECODER_GetText per CSBK opcode\n");
+	Csbks.Weights[GENERATOR_CSBK] = 1;
+	for (i = 0; i < sizeof(kOpcodes) / sizeof(kOpcodes[0]); i++) {
+		char Name[32];
+
+		pBuffer = Generate(&Csbks, kOpcodes[i].Opcode, &Length, &Frames);
+		if (!pBuffer) {
+			return false;
+		}
+		snprintf(Name, sizeof(Name), "0x%02X %s", kOpcodes[i].Opcode, kOpcodes[i].pName);
+		Measure(Name, "frame", GetText, pBuffer, Length);
+		free(pBuffer);
+	}
+
+	return true;
+}
+
+bool BENCH_Fuzz(const GeneratorMix_t *pMix, uint64_t Seconds)
+{
+	const size_t Size = BENCH_FUZZ_FRAMES * 128;
+	// A power of two over twice the frames of a round
+	const size_t Slots = 1U << 18;
+	const uint64_t Begin = CLOCK_GetMonotonic();
+	Fuzz_t Fuzz;
+	uint8_t *pStream;
+	uint64_t Round;
+
+	memset(&Fuzz, 0, sizeof(Fuzz));
+	Fuzz.Mask = Slots - 1;
+	Fuzz.pIntact = (FuzzFrame_t *)malloc(Slots * sizeof(FuzzFrame_t));
+	pStream = (uint8_t *)malloc(Size);
+	if (!Fuzz.pIntact || !pStream) {
+		free(Fuzz.pIntact);
+		free(pStream);
+		return false;
+	}
+
+	for (Round = 1; !Fuzz.bViolation; Round++) {
+		const uint32_t Seed = (uint32_t)(CLOCK_GetRealtime() ^ Round) | 1;
+		Generator_t *pGenerator = GENERATOR_New(pMix, Seed);
+		DecoderStats_t Stats;
+		size_t Length;
+
+		if (!pGenerator) {
+			break;
+		}
+		// Intact frames are only matched within their round, the counts add up
+		memset(Fuzz.pIntact, 0, Slots * sizeof(FuzzFrame_t));
+		Fuzz.State = Seed;
+		Length = BuildStream(&Fuzz, pGenerator, pStream, Size);
+		GENERATOR_Free(pGenerator);
+		DecodeStream(&Fuzz, pStream, Length, &Stats);
+
+		printf("Round %llu, seed %u: %llu errors, %.2f frames lost per error, %llu resyncs, %llu bad lengths, "
+			"%.1f ns/byte on average, %.1f ns/byte at worst\n",
+			(unsigned long long)Round, (unsigned)Seed, (unsigned long long)Fuzz.Errors,
+			Fuzz.Errors ? (double)(Fuzz.Intact - Fuzz.Found) / (double)Fuzz.Errors : 0.0,
+			(unsigned long long)Stats.Resyncs, (unsigned long long)Stats.BadLengths,
+			(double)Fuzz.DecodeNs / (double)Fuzz.Bytes, Fuzz.WorstNs);
+		fflush(stdout);
+
+		if (Seconds && CLOCK_GetMonotonic() - Begin >= Seconds * 1000000000ULL) {
+			break;
+		}
+	}
+
+	free(Fuzz.pIntact);
+	free(pStream);
+
+	return !Fuzz.bViolation;
+}
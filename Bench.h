@@ -0,0 +1,46 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include "Generator.h"
+
+// Times the decoder on synthetic traffic and prints the results on stdout:
+// field extraction, framing, DECODER_GetText() per CSBK opcode, and bytes to
+// text for the whole mix.
+enum {
+	BENCH_BYTES = 8 * 1024 * 1024,
+	BENCH_MIN_MS = 300, // Each measure repeats until it has run this long
+	BENCH_FUZZ_FRAMES = 100000, // Frames per fuzz round
+	BENCH_FUZZ_CHUNK = 4096,    // Bytes handed to the decoder at once
+	BENCH_FUZZ_PERCENT = 5,     // Frames hit by an injected error
+};
+
+// Checks the renderers and bit readers against known answers before -b and
+// -z, printing each mismatch. Returns false if any is found.
+bool BENCH_Check(void);
+bool BENCH_Run(const GeneratorMix_t *pMix);
+// Feeds the framer and decoders synthetic traffic with bit flips, truncated
+// frames, garbage, false magics with long lengths and random frames, for
+// Seconds or forever when 0. Reports the frames lost per injected error and
+// the worst CPU time per input byte. Every frame is also decoded from a copy
+// of exactly its length, so a sanitizer build catches any read past it.
+// Returns false if an event points outside its frame.
+bool BENCH_Fuzz(const GeneratorMix_t *pMix, uint64_t Seconds);
+
+#endif
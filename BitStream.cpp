@@ -84,6 +84,19 @@ bool BS_PopBits(BitStream_t *pBs, size_t Bits, void *pBuffer, size_t Length)
 
 	memset(pBuffer, 0, Length);
 
+	if (Bits <= BS_MAX_EXTRACT) {
+		uint64_t Value = BS_ExtractBits(pBs, Bits);
+		size_t i = (Bits + 7U) / 8U;
+
+		while (i > 0U) {
+			pBytes[--i] = (uint8_t)Value;
+			Value >>= 8;
+		}
+
+		return true;
+	}
+
+	pBs->CacheBits = 0;
 	if (Count > 0U) {
 		*pBytes++ = GetBits(pBs, Count);
 		Bits -= Count;
@@ -117,8 +130,22 @@ bool BS_PopUInt(BitStream_t *pBs, size_t Bits, void *pBuffer, size_t Length)
 		return false;
 	}
 
+	if (Bits <= BS_MAX_EXTRACT) {
+		uint64_t Value = BS_ExtractBits(pBs, Bits);
+		size_t i;
+
+		// Little endian, whatever the width of the destination
+		for (i = 0; i < Length; i++) {
+			pBytes[i] = (uint8_t)Value;
+			Value >>= 8;
+		}
+
+		return true;
+	}
+
 	memset(pBuffer, 0, Length);
 
+	pBs->CacheBits = 0;
 	pBytes += (Bits - 1U) / 8U;
 	if (Count > 0U) {
 		*pBytes-- = GetBits(pBs, Count);
@@ -140,30 +167,24 @@ bool BS_PopU8(BitStream_t *pBs, uint8_t *pValue)
 
 bool BS_PopU16(BitStream_t *pBs, uint16_t *pValue)
 {
-	uint8_t Array[2];
-	bool Success;
-
-	Success = BS_PopBits(pBs, 16U, Array, sizeof(Array));
-
-	if (Success) {
-		*pValue = (uint16_t)((Array[0] << 8) | Array[1]);
+	if (!BS_Need(pBs, 16U)) {
+		return false;
 	}
 
-	return Success;
+	*pValue = (uint16_t)BS_ExtractBits(pBs, 16U);
+
+	return true;
 }
 
 bool BS_PopU32(BitStream_t *pBs, uint32_t *pValue)
 {
-	uint8_t Array[4];
-	bool Success;
-
-	Success = BS_PopBits(pBs, 32U, Array, sizeof(Array));
-
-	if (Success) {
-		*pValue = (uint32_t)((Array[0] << 24) | (Array[1] << 16) | (Array[2] << 8) | Array[3]);
+	if (!BS_Need(pBs, 32U)) {
+		return false;
 	}
 
-	return Success;
+	*pValue = (uint32_t)BS_ExtractBits(pBs, 32U);
+
+	return true;
 }
 
 bool BS_PopU64(BitStream_t *pBs, uint64_t *pValue)
@@ -184,10 +205,17 @@ bool BS_SkipBits(BitStream_t *pBs, size_t Bits)
 {
 	if (pBs->Position + Bits > pBs->Length) {
 		return false;
+	}
+
+	if (Bits < pBs->CacheBits) {
+		pBs->Cache <<= Bits;
+		pBs->CacheBits -= Bits;
 	} else {
-		pBs->Position += Bits;
-		return true;
+		pBs->CacheBits = 0;
 	}
+	pBs->Position += Bits;
+
+	return true;
 }
 
 bool BS_SkipBytes(BitStream_t *pBs, size_t Bytes)
@@ -217,15 +245,7 @@ bool BS_GetSubStream(BitStream_t *pBs, BitStream_t *pOut, size_t Length)
 	pOut->Position = pBs->Position & 7U;
 
 	pBs->Position += Length;
-
-	return true;
-}
-
-bool BS_Need(const BitStream_t *pBs, size_t Bits)
-{
-	if (!pBs || pBs->Position + Bits > pBs->Length) {
-		return false;
-	}
+	pBs->CacheBits = 0;
 
 	return true;
 }
@@ -274,3 +294,64 @@ const uint8_t *BS_GetCurrentPtr(const BitStream_t *pBs)
 	return pBs->pStream + BS_GetConsumedBytes(pBs);
 }
 
+
+void BW_Init(BitWriter_t *pBw, uint8_t *pStream, size_t Length)
+{
+	memset(pBw, 0, sizeof(*pBw));
+	pBw->pStream = pStream;
+	pBw->Length = Length * 8U;
+}
+
+bool BW_PushBits(BitWriter_t *pBw, uint64_t Value, size_t Bits)
+{
+	if (Bits > 64U || pBw->Position + Bits > pBw->Length) {
+		return false;
+	}
+
+	while (Bits) {
+		const size_t Index = pBw->Position / 8U;
+		const size_t Free = GEN_DOWN_SHIFT(pBw->Position % 8U);
+		const size_t Count = Bits < Free ? Bits : Free;
+		const uint8_t Field = (uint8_t)((Value >> (Bits - Count)) & GEN_MASK(Count));
+
+		// The first write to a byte clears what was there
+		if (Free == 8U) {
+			pBw->pStream[Index] = 0;
+		}
+		pBw->pStream[Index] |= (uint8_t)(Field << (Free - Count));
+		pBw->Position += Count;
+		Bits -= Count;
+	}
+
+	return true;
+}
+
+bool BW_PushU8(BitWriter_t *pBw, uint8_t Value)
+{
+	return BW_PushBits(pBw, Value, 8);
+}
+
+bool BW_PushU16(BitWriter_t *pBw, uint16_t Value)
+{
+	return BW_PushBits(pBw, Value, 16);
+}
+
+bool BW_PushBytes(BitWriter_t *pBw, const void *pBuffer, size_t Bytes)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	size_t i;
+
+	if (pBw->Position + Bytes * 8U > pBw->Length) {
+		return false;
+	}
+	for (i = 0; i < Bytes; i++) {
+		BW_PushBits(pBw, pBytes[i], 8);
+	}
+
+	return true;
+}
+
+size_t BW_GetLengthBytes(const BitWriter_t *pBw)
+{
+	return (pBw->Position + 7U) / 8U;
+}
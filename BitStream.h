@@ -20,13 +20,29 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
 
+// Cache holds the CacheBits bits that follow Position, most significant bit
+// first. Only BitStream.cpp and the functions below move Position, and they
+// keep the cache in step or empty it.
 typedef struct BitStream_t {
 	const uint8_t *pStream;
 	size_t Length;
 	size_t Position;
+	uint64_t Cache;
+	size_t CacheBits;
 } BitStream_t;
 
+// Writing counterpart of BitStream_t, fields go in most significant bit first
+typedef struct BitWriter_t {
+	uint8_t *pStream;
+	size_t Length;
+	size_t Position;
+} BitWriter_t;
+
 void BS_Init(BitStream_t *pBs, const uint8_t *pStream, size_t Length);
 bool BS_PopBits(BitStream_t *pBs, size_t Bits, void *pBuffer, size_t Length);
 bool BS_PopBytes(BitStream_t *pBs, size_t Bytes, void *pBuffer, size_t Length);
@@ -38,7 +54,6 @@ bool BS_PopU64(BitStream_t *pBs, uint64_t *pValue);
 bool BS_SkipBits(BitStream_t *pBs, size_t Bits);
 bool BS_SkipBytes(BitStream_t *pBs, size_t Bytes);
 bool BS_GetSubStream(BitStream_t *pBs, BitStream_t *pOut, size_t Length);
-bool BS_Need(const BitStream_t *pBs, size_t Bits);
 bool BS_Eof(const BitStream_t *pBs);
 void BS_Shrink(BitStream_t *pBs, size_t Bits);
 size_t BS_GetRemainingBytes(const BitStream_t *pBs);
@@ -46,4 +61,81 @@ size_t BS_AdjustLengthBytes(const BitStream_t *pBs, size_t Length);
 size_t BS_GetConsumedBytes(const BitStream_t *pBs);
 const uint8_t *BS_GetCurrentPtr(const BitStream_t *pBs);
 
+void BW_Init(BitWriter_t *pBw, uint8_t *pStream, size_t Length);
+// Up to 64 bits, false and nothing written if they do not fit
+bool BW_PushBits(BitWriter_t *pBw, uint64_t Value, size_t Bits);
+bool BW_PushU8(BitWriter_t *pBw, uint8_t Value);
+bool BW_PushU16(BitWriter_t *pBw, uint16_t Value);
+bool BW_PushBytes(BitWriter_t *pBw, const void *pBuffer, size_t Bytes);
+// Bytes written so far, a partial last byte counts
+size_t BW_GetLengthBytes(const BitWriter_t *pBw);
+
+// Unchecked fast path for fields of up to BS_MAX_EXTRACT bits. Callers check
+// BS_Need() once for the whole record, then extract each field with a shift
+// off the cache. The cache is refilled with one unaligned big-endian load.
+#define BS_MAX_EXTRACT	57U
+
+// Inline so that a reader checked once per record stays in registers
+static inline bool BS_Need(const BitStream_t *pBs, size_t Bits)
+{
+	return pBs && pBs->Position + Bits <= pBs->Length;
+}
+
+static inline uint64_t BS_LoadBigEndian(const uint8_t *pBytes)
+{
+	uint64_t Word;
+
+	memcpy(&Word, pBytes, sizeof(Word));
+#if defined(_MSC_VER)
+	return _byteswap_uint64(Word);
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	return Word;
+#else
+	return __builtin_bswap64(Word);
+#endif
+}
+
+// Loads at least BS_MAX_EXTRACT bits from Position, fewer only at the end of
+// the stream, and never reads past its last byte
+static inline void BS_Refill(BitStream_t *pBs)
+{
+	const size_t Index = pBs->Position / 8U;
+	const size_t Shift = pBs->Position & 7U;
+	const size_t End = (pBs->Length + 7U) / 8U;
+	const size_t Available = End > Index ? End - Index : 0;
+
+	if (Available >= 8U) {
+		pBs->Cache = BS_LoadBigEndian(pBs->pStream + Index) << Shift;
+		pBs->CacheBits = 64U - Shift;
+	} else {
+		uint64_t Word = 0;
+		size_t i;
+
+		for (i = 0; i < Available; i++) {
+			Word |= (uint64_t)pBs->pStream[Index + i] << (56U - (i * 8U));
+		}
+		pBs->Cache = Word << Shift;
+		pBs->CacheBits = Available ? Available * 8U - Shift : 0U;
+	}
+}
+
+static inline uint64_t BS_ExtractBits(BitStream_t *pBs, size_t Bits)
+{
+	uint64_t Value;
+
+	if (!Bits) {
+		return 0;
+	}
+	if (pBs->CacheBits < Bits) {
+		BS_Refill(pBs);
+	}
+	Value = pBs->Cache >> (64U - Bits);
+	pBs->Cache <<= Bits;
+	// Past the end only without BS_Need(), the next call reloads
+	pBs->CacheBits = pBs->CacheBits > Bits ? pBs->CacheBits - Bits : 0U;
+	pBs->Position += Bits;
+
+	return Value;
+}
+
 #endif
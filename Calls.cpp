@@ -0,0 +1,367 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Calls.h"
+
+#define CALLS_TICK_NS	(CALLS_TICK_MS * 1000000ULL)
+
+enum {
+	CALLS_TABLE = CALLS_MAX * 2, // Open addressing, kept at most half full
+	CALLS_NONE = 0xFFFF,
+};
+
+typedef struct Call_t {
+	EventCall_t Call;
+	uint64_t Key;
+	uint64_t Deadline;
+	const char *pPort;
+	uint8_t Port;
+	uint8_t Ts;
+	uint8_t Cc;
+	bool bUsed;
+	// Timer wheel bucket, or the free list through Next
+	uint16_t Next;
+	uint16_t Prev;
+	uint16_t Bucket;
+	char Alias[EVENT_MAX_ALIAS];
+} Call_t;
+
+struct Calls_t {
+	CallHandler_t pHandler;
+	void *pContext;
+	// Next tick of the wheel to run, 0 until the first timed event
+	uint64_t Tick;
+	uint16_t Free;
+	uint16_t Table[CALLS_TABLE];
+	uint16_t Wheel[CALLS_WHEEL];
+	// Call last heard on each port and timeslot, for aliases and refreshes
+	uint16_t Current[256][2];
+	Call_t Pool[CALLS_MAX];
+};
+
+// Private
+
+static uint64_t GetKey(uint8_t Port, uint8_t Ts, uint32_t Source, uint32_t Target)
+{
+	return ((uint64_t)Port << 56) | ((uint64_t)(Ts & 3) << 48) | ((uint64_t)(Source & 0xFFFFFF) << 24) | (Target & 0xFFFFFF);
+}
+
+static size_t GetHome(uint64_t Key)
+{
+	return (size_t)((Key * 0x9E3779B97F4A7C15ULL) >> 40) & (CALLS_TABLE - 1);
+}
+
+// Returns the table slot holding the key, or the empty slot it would go in
+static size_t Lookup(const Calls_t *pCalls, uint64_t Key)
+{
+	size_t Slot = GetHome(Key);
+
+	while (pCalls->Table[Slot] != CALLS_NONE && pCalls->Pool[pCalls->Table[Slot]].Key != Key) {
+		Slot = (Slot + 1) & (CALLS_TABLE - 1);
+	}
+
+	return Slot;
+}
+
+// Backward shift deletion, so that lookups never need tombstones
+static void Unindex(Calls_t *pCalls, uint64_t Key)
+{
+	size_t Hole = Lookup(pCalls, Key);
+	size_t Slot = Hole;
+
+	if (pCalls->Table[Hole] == CALLS_NONE) {
+		return;
+	}
+
+	for (;;) {
+		size_t Home;
+
+		Slot = (Slot + 1) & (CALLS_TABLE - 1);
+		if (pCalls->Table[Slot] == CALLS_NONE) {
+			break;
+		}
+		Home = GetHome(pCalls->Pool[pCalls->Table[Slot]].Key);
+		// Move the entry back unless its home lies cyclically in (Hole, Slot]
+		if (((Slot - Home) & (CALLS_TABLE - 1)) >= ((Slot - Hole) & (CALLS_TABLE - 1))) {
+			pCalls->Table[Hole] = pCalls->Table[Slot];
+			Hole = Slot;
+		}
+	}
+	pCalls->Table[Hole] = CALLS_NONE;
+}
+
+static void Link(Calls_t *pCalls, uint16_t Index)
+{
+	Call_t *pCall = &pCalls->Pool[Index];
+	const uint16_t Bucket = (uint16_t)((pCall->Deadline / CALLS_TICK_NS) % CALLS_WHEEL);
+
+	pCall->Bucket = Bucket;
+	pCall->Prev = CALLS_NONE;
+	pCall->Next = pCalls->Wheel[Bucket];
+	if (pCall->Next != CALLS_NONE) {
+		pCalls->Pool[pCall->Next].Prev = Index;
+	}
+	pCalls->Wheel[Bucket] = Index;
+}
+
+static void Unlink(Calls_t *pCalls, uint16_t Index)
+{
+	Call_t *pCall = &pCalls->Pool[Index];
+
+	if (pCall->Prev != CALLS_NONE) {
+		pCalls->Pool[pCall->Prev].Next = pCall->Next;
+	} else {
+		pCalls->Wheel[pCall->Bucket] = pCall->Next;
+	}
+	if (pCall->Next != CALLS_NONE) {
+		pCalls->Pool[pCall->Next].Prev = pCall->Prev;
+	}
+}
+
+// Hands the call over and gives its slot back
+static void End(Calls_t *pCalls, uint16_t Index)
+{
+	Call_t *pCall = &pCalls->Pool[Index];
+	EventSource_t Source;
+	Event_t Event;
+
+	memset(&Event, 0, sizeof(Event));
+	Event.Type = EVENT_CALL;
+	Event.Ts = pCall->Ts;
+	Event.Cc = pCall->Cc;
+	Event.Call = pCall->Call;
+
+	Source.Realtime = pCall->Call.Start;
+	Source.Port = pCall->Port;
+	Source.pPort = pCall->pPort;
+
+	pCalls->pHandler(pCalls->pContext, &Event, &Source);
+
+	Unindex(pCalls, pCall->Key);
+	Unlink(pCalls, Index);
+	if (pCalls->Current[pCall->Port][pCall->Ts & 1] == Index) {
+		pCalls->Current[pCall->Port][pCall->Ts & 1] = CALLS_NONE;
+	}
+	pCall->bUsed = false;
+	pCall->Next = pCalls->Free;
+	pCalls->Free = Index;
+}
+
+// Runs out of slots only when every call is live, the quietest one goes first
+static void EndQuietest(Calls_t *pCalls)
+{
+	uint16_t Quietest = 0;
+	uint16_t i;
+
+	for (i = 1; i < CALLS_MAX; i++) {
+		if (pCalls->Pool[i].Call.End < pCalls->Pool[Quietest].Call.End) {
+			Quietest = i;
+		}
+	}
+	End(pCalls, Quietest);
+}
+
+static uint16_t Open(Calls_t *pCalls, const Event_t *pEvent, const EventSource_t *pSource, uint8_t Ts, uint32_t Source, uint32_t Target)
+{
+	const uint64_t Key = GetKey(pSource->Port, Ts, Source, Target);
+	size_t Slot = Lookup(pCalls, Key);
+	Call_t *pCall;
+	uint16_t Index;
+
+	if (pCalls->Table[Slot] != CALLS_NONE) {
+		Index = pCalls->Table[Slot];
+		pCall = &pCalls->Pool[Index];
+		Unlink(pCalls, Index);
+	} else {
+		if (pCalls->Free == CALLS_NONE) {
+			EndQuietest(pCalls);
+			Slot = Lookup(pCalls, Key);
+		}
+		Index = pCalls->Free;
+		pCall = &pCalls->Pool[Index];
+		pCalls->Free = pCall->Next;
+		pCalls->Table[Slot] = Index;
+
+		memset(pCall, 0, sizeof(*pCall));
+		pCall->bUsed = true;
+		pCall->Key = Key;
+		pCall->Port = pSource->Port;
+		pCall->pPort = pSource->pPort;
+		pCall->Ts = Ts;
+		pCall->Call.Source = Source;
+		pCall->Call.Target = Target;
+		pCall->Call.Start = pSource->Realtime;
+	}
+
+	if (pEvent->Type != EVENT_PV_GRANT && pEvent->Type != EVENT_TV_GRANT && pEvent->Type != EVENT_BTV_GRANT) {
+		pCall->Cc = pEvent->Cc;
+	}
+	pCall->Call.End = pSource->Realtime;
+	pCall->Deadline = pSource->Realtime + CALLS_TIMEOUT_MS * 1000000ULL;
+	Link(pCalls, Index);
+	pCalls->Current[pSource->Port][Ts & 1] = Index;
+
+	return Index;
+}
+
+// Ends the calls due by the end of the tick, at a tick's granularity. The
+// others are a whole turn of the wheel away and go back in.
+static void RunTick(Calls_t *pCalls, uint64_t Tick)
+{
+	const size_t Bucket = (size_t)(Tick % CALLS_WHEEL);
+	uint16_t Index = pCalls->Wheel[Bucket];
+
+	pCalls->Wheel[Bucket] = CALLS_NONE;
+	while (Index != CALLS_NONE) {
+		Call_t *pCall = &pCalls->Pool[Index];
+		const uint16_t Next = pCall->Next;
+
+		// End() expects the call to be linked
+		Link(pCalls, Index);
+		if (pCall->Deadline / CALLS_TICK_NS <= Tick) {
+			End(pCalls, Index);
+		}
+		Index = Next;
+	}
+}
+
+// Public
+
+Calls_t *CALLS_New(CallHandler_t pHandler, void *pContext)
+{
+	Calls_t *pCalls;
+	uint16_t i;
+
+	pCalls = (Calls_t *)calloc(1, sizeof(Calls_t));
+	if (!pCalls) {
+		return NULL;
+	}
+	pCalls->pHandler = pHandler;
+	pCalls->pContext = pContext;
+	memset(pCalls->Table, 0xFF, sizeof(pCalls->Table));
+	memset(pCalls->Wheel, 0xFF, sizeof(pCalls->Wheel));
+	memset(pCalls->Current, 0xFF, sizeof(pCalls->Current));
+	for (i = 0; i < CALLS_MAX; i++) {
+		pCalls->Pool[i].Next = (i + 1 < CALLS_MAX) ? (uint16_t)(i + 1) : (uint16_t)CALLS_NONE;
+	}
+	pCalls->Free = 0;
+
+	return pCalls;
+}
+
+void CALLS_Free(Calls_t *pCalls)
+{
+	free(pCalls);
+}
+
+bool CALLS_Add(Calls_t *pCalls, const Event_t *pEvent, const EventSource_t *pSource)
+{
+	uint16_t Index;
+	Call_t *pCall;
+
+	if (pEvent->Flags & EVENT_INCOMPLETE) {
+		return false;
+	}
+	if (pSource->Realtime) {
+		CALLS_Expire(pCalls, pSource->Realtime);
+	}
+
+	switch (pEvent->Type) {
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+		// Keyed by the traffic timeslot, where the call LCs will show up
+		Index = Open(pCalls, pEvent, pSource, pEvent->Grant.Slot, pEvent->Grant.Source, pEvent->Grant.Target);
+		pCall = &pCalls->Pool[Index];
+		pCall->Call.Channel = pEvent->Grant.Channel;
+		pCall->Call.Slot = pEvent->Grant.Slot;
+		pCall->Call.bPrivate = pEvent->Type == EVENT_PV_GRANT;
+		pCall->Call.bEmergency |= pEvent->Grant.bEmergency;
+		pCall->Call.bLateEntry |= pEvent->Grant.bLateEntry;
+		return true;
+
+	case EVENT_VOICE_LC:
+	case EVENT_TERM_LC:
+		// Only group and private calls are parsed, the rest stays raw
+		if (pEvent->pData) {
+			return false;
+		}
+		Index = Open(pCalls, pEvent, pSource, pEvent->Ts, pEvent->Lc.Source, pEvent->Lc.Target);
+		pCall = &pCalls->Pool[Index];
+		pCall->Call.bPrivate = pEvent->Opcode == 3;
+		pCall->Call.bEmergency |= (pEvent->Lc.Options & 0x80) != 0;
+		if (pEvent->Type == EVENT_TERM_LC) {
+			pCall->Call.bEnded = true;
+			End(pCalls, Index);
+		}
+		return true;
+
+	case EVENT_TALKER_ALIAS:
+		Index = pCalls->Current[pSource->Port][pEvent->Ts & 1];
+		if (Index == CALLS_NONE) {
+			return false;
+		}
+		pCall = &pCalls->Pool[Index];
+		memcpy(pCall->Alias, pEvent->Alias.pText, pEvent->Alias.Length);
+		pCall->Call.pAlias = pCall->Alias;
+		pCall->Call.AliasLength = pEvent->Alias.Length;
+		pCall->Call.AliasFormat = pEvent->Alias.Format;
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+void CALLS_Expire(Calls_t *pCalls, uint64_t Now)
+{
+	const uint64_t NowTick = Now / CALLS_TICK_NS;
+	size_t i;
+
+	if (!pCalls->Tick || NowTick < pCalls->Tick) {
+		if (!pCalls->Tick) {
+			pCalls->Tick = NowTick;
+		}
+		return;
+	}
+
+	// After a long gap every bucket is due, run each of them once
+	if (NowTick - pCalls->Tick >= CALLS_WHEEL) {
+		for (i = 0; i < CALLS_WHEEL; i++) {
+			RunTick(pCalls, NowTick - i);
+		}
+		pCalls->Tick = NowTick + 1;
+		return;
+	}
+
+	while (pCalls->Tick <= NowTick) {
+		RunTick(pCalls, pCalls->Tick);
+		pCalls->Tick++;
+	}
+}
+
+void CALLS_Flush(Calls_t *pCalls)
+{
+	uint16_t i;
+
+	for (i = 0; i < CALLS_MAX; i++) {
+		if (pCalls->Pool[i].bUsed) {
+			End(pCalls, i);
+		}
+	}
+}
@@ -0,0 +1,52 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef CALLS_H
+#define CALLS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Event.h"
+
+// Folds the grants, call LC headers, talker aliases and terminators of each
+// call into a single EVENT_CALL. Calls are keyed by port, timeslot, source
+// and target. A call ends with its terminator, or once nothing was heard from
+// it for CALLS_TIMEOUT_MS.
+enum {
+	CALLS_MAX = 1024,      // Calls followed at once, the quietest is ended to make room
+	CALLS_TIMEOUT_MS = 3000,
+	CALLS_TICK_MS = 100,
+	CALLS_WHEEL = 64,      // Ticks, more than the timeout
+};
+
+// Receives each call as it ends, the event is only valid during the call
+typedef void (*CallHandler_t)(void *pContext, const Event_t *pCall, const EventSource_t *pSource);
+
+typedef struct Calls_t Calls_t;
+
+Calls_t *CALLS_New(CallHandler_t pHandler, void *pContext);
+void CALLS_Free(Calls_t *pCalls);
+
+// Returns true when the event was folded into a call and needs no line of its
+// own. The event time also drives the expiry of quiet calls.
+bool CALLS_Add(Calls_t *pCalls, const Event_t *pEvent, const EventSource_t *pSource);
+// Ends the calls that went quiet before Now, a realtime in ns
+void CALLS_Expire(Calls_t *pCalls, uint64_t Now);
+// Ends every call, once the capture or replay is over
+void CALLS_Flush(Calls_t *pCalls);
+
+#endif
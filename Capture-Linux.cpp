@@ -0,0 +1,306 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <linux/serial.h>
+#include <string>
+#include "Capture.h"
+#include "Clock.h"
+
+enum {
+	// A single read drains several frames worth of the tty buffer
+	CAPTURE_READ_SIZE = 4096,
+};
+
+static volatile sig_atomic_t gbStop;
+static bool gbConsole = true;
+// CAPTURE_Stop() writes a byte to wake up the capture
+static int gStopPipe[2] = { -1, -1 };
+
+static bool StopRequested(int Timeout)
+{
+	struct pollfd Fds[2];
+
+	Fds[0].fd = gStopPipe[0];
+	Fds[0].events = POLLIN;
+	Fds[0].revents = 0;
+	Fds[1].fd = STDIN_FILENO;
+	Fds[1].events = POLLIN;
+	Fds[1].revents = 0;
+
+	if (!gbStop) {
+		poll(Fds, gbConsole ? 2 : 1, Timeout);
+	}
+
+	return gbStop || (Fds[1].revents & POLLIN);
+}
+
+// Returns false once the port is gone
+static bool DrainPort(int Fd, const CapturePort_t *pPort, CaptureHandler_t pHandler, uint32_t Events)
+{
+	for (;;) {
+		uint8_t Buffer[CAPTURE_READ_SIZE];
+		ssize_t Length;
+
+		Length = read(Fd, Buffer, sizeof(Buffer));
+		if (Length > 0) {
+			pHandler(pPort->pContext, Buffer, (size_t)Length, CLOCK_GetMonotonic());
+			if ((size_t)Length < sizeof(Buffer)) {
+				return true;
+			}
+			continue;
+		}
+		if (Length < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Length < 0 && errno != EAGAIN) {
+			fprintf(stderr, "Error reading from %s (%d)\n", pPort->pName, errno);
+			return false;
+		}
+		if (Events & (EPOLLERR | EPOLLHUP)) {
+			fprintf(stderr, "Error: %s disconnected.\n", pPort->pName);
+			return false;
+		}
+		return true;
+	}
+}
+
+static void Capture(const int *pFds, const CapturePort_t *pPorts, size_t Count, CaptureHandler_t pHandler)
+{
+	struct epoll_event Event;
+	size_t Active = Count;
+	int Epoll;
+	size_t i;
+
+	Epoll = epoll_create1(EPOLL_CLOEXEC);
+	if (Epoll < 0) {
+		fprintf(stderr, "Error: Failed to create epoll set (%d).\n", errno);
+		return;
+	}
+
+	// All the ports share one set, the event data is the port index
+	memset(&Event, 0, sizeof(Event));
+	Event.events = EPOLLIN;
+	for (i = 0; i < Count; i++) {
+		Event.data.u64 = i;
+		if (epoll_ctl(Epoll, EPOLL_CTL_ADD, pFds[i], &Event) < 0) {
+			fprintf(stderr, "Error: Failed to watch %s (%d).\n", pPorts[i].pName, errno);
+			close(Epoll);
+			return;
+		}
+	}
+
+	// The stop pipe and any input on the console end the capture, like
+	// _kbhit() on Windows. Watching stdin fails harmlessly when it is a file
+	// or /dev/null.
+	Event.data.u64 = Count;
+	if (epoll_ctl(Epoll, EPOLL_CTL_ADD, gStopPipe[0], &Event) < 0) {
+		fprintf(stderr, "Error: Failed to watch the stop pipe (%d).\n", errno);
+		close(Epoll);
+		return;
+	}
+	if (gbConsole) {
+		epoll_ctl(Epoll, EPOLL_CTL_ADD, STDIN_FILENO, &Event);
+	}
+
+	while (Active && !gbStop) {
+		struct epoll_event Events[CAPTURE_MAX_PORTS + 1];
+		int Ready;
+		int j;
+
+		// Block until a radio sends something, no polling when idle
+		Ready = epoll_wait(Epoll, Events, CAPTURE_MAX_PORTS + 1, -1);
+		if (Ready < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fprintf(stderr, "Error: Failed to wait for ports (%d).\n", errno);
+			break;
+		}
+
+		for (j = 0; j < Ready && Active; j++) {
+			const size_t Index = (size_t)Events[j].data.u64;
+
+			if (Index == Count) {
+				Active = 0;
+			} else if (!DrainPort(pFds[Index], &pPorts[Index], pHandler, Events[j].events)) {
+				epoll_ctl(Epoll, EPOLL_CTL_DEL, pFds[Index], NULL);
+				Active--;
+			}
+		}
+	}
+
+	close(Epoll);
+}
+
+static int StartCapture(const char *pPortName)
+{
+	struct termios Tty;
+	struct serial_struct Serial;
+	std::string fullPortName;
+	int Fd;
+
+	if (!strchr(pPortName, '/')) {
+		fullPortName = "/dev/";
+	}
+	fullPortName += pPortName;
+
+	fprintf(stderr, "Waiting for port %s...\n", pPortName);
+	do {
+		Fd = open(fullPortName.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	} while (Fd < 0 && !StopRequested(100));
+
+	if (Fd < 0) {
+		fprintf(stderr, "Exiting...\n");
+		return Fd;
+	}
+
+	fprintf(stderr, "Configuring port...\n");
+
+	if (tcgetattr(Fd, &Tty) < 0) {
+		fprintf(stderr, "Error: Failed to get port state.\n");
+		close(Fd);
+		return -1;
+	}
+
+	cfmakeraw(&Tty);
+	cfsetispeed(&Tty, B115200);
+	cfsetospeed(&Tty, B115200);
+	Tty.c_cflag |= CLOCAL | CREAD;
+
+	// Reads are driven by epoll readiness on a non-blocking descriptor, so
+	// a read must return whatever the driver holds right away. Any VMIN or
+	// VTIME inter-byte timer would only delay the frame that just arrived.
+	Tty.c_cc[VMIN] = 0;
+	Tty.c_cc[VTIME] = 0;
+
+	if (tcsetattr(Fd, TCSANOW, &Tty) < 0) {
+		fprintf(stderr, "Error: Failed to set port state.\n");
+		close(Fd);
+		return -1;
+	}
+
+	// Ask USB serial drivers to push bytes up without their latency timer.
+	// Not every driver supports this, which is fine.
+	if (!ioctl(Fd, TIOCGSERIAL, &Serial)) {
+		Serial.flags |= ASYNC_LOW_LATENCY;
+		ioctl(Fd, TIOCSSERIAL, &Serial);
+	}
+
+	fprintf(stderr, "Port initialised...\n");
+
+	return Fd;
+}
+
+static void StopCapture(int Fd)
+{
+	if (Fd >= 0) {
+		close(Fd);
+	}
+}
+
+void CAPTURE_ListPorts(void)
+{
+	static const char *kPatterns[] = { "/dev/ttyACM*", "/dev/ttyUSB*" };
+	glob_t Glob;
+	size_t i;
+	int Flags = 0;
+
+	memset(&Glob, 0, sizeof(Glob));
+	for (i = 0; i < sizeof(kPatterns) / sizeof(kPatterns[0]); i++) {
+		glob(kPatterns[i], Flags, NULL, &Glob);
+		Flags = GLOB_APPEND;
+	}
+
+	for (i = 0; i < Glob.gl_pathc; i++) {
+		printf("-> %s\n", Glob.gl_pathv[i]);
+	}
+
+	if (!Glob.gl_pathc) {
+		printf("No serial ports found.\n");
+	}
+
+	globfree(&Glob);
+}
+
+bool CAPTURE_Run(const CapturePort_t *pPorts, size_t Count, CaptureHandler_t pHandler)
+{
+	int Fds[CAPTURE_MAX_PORTS];
+	size_t i;
+
+	if (!Count || Count > CAPTURE_MAX_PORTS) {
+		return false;
+	}
+
+	// Kept open for good, a signal handler may still write to it
+	if (gStopPipe[0] < 0 && pipe2(gStopPipe, O_NONBLOCK | O_CLOEXEC) < 0) {
+		fprintf(stderr, "Error: Failed to create the stop pipe (%d).\n", errno);
+		return false;
+	}
+
+	for (i = 0; i < Count; i++) {
+		Fds[i] = StartCapture(pPorts[i].pName);
+		if (Fds[i] < 0) {
+			while (i--) {
+				StopCapture(Fds[i]);
+			}
+			return false;
+		}
+	}
+
+	Capture(Fds, pPorts, Count, pHandler);
+
+	for (i = 0; i < Count; i++) {
+		StopCapture(Fds[i]);
+	}
+
+	fprintf(stderr, "Stopped capturing data.\n");
+
+	return true;
+}
+
+void CAPTURE_SetConsole(bool bConsole)
+{
+	gbConsole = bConsole;
+}
+
+void CAPTURE_Stop(void)
+{
+	const uint8_t Byte = 0;
+
+	gbStop = 1;
+
+	// A full pipe already has a wake up pending
+	if (gStopPipe[1] >= 0) {
+		const ssize_t Written = write(gStopPipe[1], &Byte, 1);
+
+		(void)Written;
+	}
+}
+
+#endif
@@ -0,0 +1,344 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <setupapi.h>
+#include <conio.h>
+#include <devguid.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "Capture.h"
+#include "Clock.h"
+
+#pragma comment(lib, "setupapi.lib")
+
+enum {
+	// A single read drains several frames worth of the driver buffer
+	CAPTURE_READ_SIZE = 4096,
+	// A read with nothing to return completes empty after this long
+	CAPTURE_READ_TIMEOUT_MS = 1000,
+	// How often a key press is looked for, the console has no event for it
+	CAPTURE_KEY_POLL_MS = 100,
+};
+
+// One overlapped read is always pending on each active port
+typedef struct CaptureIo_t {
+	OVERLAPPED Overlapped;
+	bool bActive;
+	uint8_t Buffer[CAPTURE_READ_SIZE];
+} CaptureIo_t;
+
+static volatile bool gbStop;
+static bool gbConsole = true;
+// Set by CAPTURE_Stop() to wake up the capture
+static HANDLE volatile ghStop;
+
+static bool StopRequested(void)
+{
+	return gbStop || (gbConsole && _kbhit());
+}
+
+static bool StartRead(HANDLE hComPort, CaptureIo_t *pIo, const char *pName)
+{
+	if (!ReadFile(hComPort, pIo->Buffer, sizeof(pIo->Buffer), NULL, &pIo->Overlapped)) {
+		DWORD error = GetLastError();
+
+		if (error != ERROR_IO_PENDING) {
+			fprintf(stderr, "Error reading from %s (%d)\n", pName, error);
+			pIo->bActive = false;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Sleeps in WaitForMultipleObjects() until a read completes or the capture
+// is stopped. Reads complete as soon as any byte arrives, see StartCapture().
+static void Capture(const HANDLE *phComPorts, const CapturePort_t *pPorts, size_t Count, CaptureHandler_t pHandler)
+{
+	CaptureIo_t *pIos = (CaptureIo_t *)calloc(Count, sizeof(CaptureIo_t));
+	HANDLE hEvents[MAXIMUM_WAIT_OBJECTS];
+	size_t Active = 0;
+	size_t i;
+
+	if (!pIos) {
+		fprintf(stderr, "Error: Out of memory.\n");
+		return;
+	}
+
+	for (i = 0; i < Count; i++) {
+		pIos[i].Overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+		pIos[i].bActive = pIos[i].Overlapped.hEvent != NULL && StartRead(phComPorts[i], &pIos[i], pPorts[i].pName);
+		if (pIos[i].bActive) {
+			Active++;
+		}
+	}
+
+	while (Active && !StopRequested()) {
+		DWORD Events = 0;
+		DWORD Result;
+
+		hEvents[Events++] = ghStop;
+		for (i = 0; i < Count; i++) {
+			if (pIos[i].bActive) {
+				hEvents[Events++] = pIos[i].Overlapped.hEvent;
+			}
+		}
+
+		Result = WaitForMultipleObjects(Events, hEvents, FALSE, gbConsole ? (DWORD)CAPTURE_KEY_POLL_MS : INFINITE);
+		if (Result == WAIT_FAILED) {
+			fprintf(stderr, "Error: Failed to wait for ports (%d).\n", GetLastError());
+			break;
+		}
+		if (Result == WAIT_TIMEOUT || Result == WAIT_OBJECT_0) {
+			continue;
+		}
+
+		for (i = 0; i < Count; i++) {
+			DWORD bytesRead = 0;
+
+			if (!pIos[i].bActive) {
+				continue;
+			}
+			if (!GetOverlappedResult(phComPorts[i], &pIos[i].Overlapped, &bytesRead, FALSE)) {
+				DWORD error = GetLastError();
+
+				if (error == ERROR_IO_INCOMPLETE) {
+					continue;
+				}
+				fprintf(stderr, "Error reading from %s (%d)\n", pPorts[i].pName, error);
+				pIos[i].bActive = false;
+				Active--;
+				continue;
+			}
+
+			// An empty read is the timeout of a quiet port
+			if (bytesRead > 0) {
+				pHandler(pPorts[i].pContext, pIos[i].Buffer, bytesRead, CLOCK_GetMonotonic());
+			}
+			if (!StartRead(phComPorts[i], &pIos[i], pPorts[i].pName)) {
+				Active--;
+			}
+		}
+	}
+
+	// The buffers must outlive the reads
+	for (i = 0; i < Count; i++) {
+		DWORD bytesRead;
+
+		if (pIos[i].bActive) {
+			CancelIo(phComPorts[i]);
+			GetOverlappedResult(phComPorts[i], &pIos[i].Overlapped, &bytesRead, TRUE);
+		}
+		if (pIos[i].Overlapped.hEvent) {
+			CloseHandle(pIos[i].Overlapped.hEvent);
+		}
+	}
+	free(pIos);
+}
+
+static HANDLE StartCapture(const char *portName)
+{
+	DCB dcb;
+	COMMTIMEOUTS timeouts;
+	HANDLE hComPort;
+
+	// Open the COM port
+	std::string fullPortName = "\\\\.\\";
+	fullPortName += portName;
+
+	fprintf(stderr, "Waiting for port %s...\n", portName);
+	do {
+		hComPort = CreateFile(
+			fullPortName.c_str(),
+			GENERIC_READ,
+			0,
+			NULL,
+			OPEN_EXISTING,
+			FILE_FLAG_OVERLAPPED,
+			NULL);
+	} while (hComPort == INVALID_HANDLE_VALUE && !StopRequested());
+
+	if (hComPort == INVALID_HANDLE_VALUE) {
+		if (StopRequested()) {
+			fprintf(stderr, "Exiting...\n");
+		} else {
+			DWORD error = GetLastError();
+
+			fprintf(stderr, "Error: Failed to open COM port (%d).\n", error);
+		}
+		return hComPort;
+	}
+
+	fprintf(stderr, "Configuring port...\n");
+
+	memset(&dcb, 0, sizeof(dcb));
+	dcb.DCBlength = sizeof(dcb);
+
+	if (!GetCommState(hComPort, &dcb)) {
+		fprintf(stderr, "Error: Failed to get COM port state.\n");
+		CloseHandle(hComPort);
+		return INVALID_HANDLE_VALUE;
+	}
+
+	dcb.BaudRate = CBR_115200;
+	dcb.ByteSize = 8;
+	dcb.Parity = NOPARITY;
+	dcb.StopBits = ONESTOPBIT;
+
+	if (!SetCommState(hComPort, &dcb)) {
+		fprintf(stderr, "Error: Failed to set COM port state.\n");
+		CloseHandle(hComPort);
+		return INVALID_HANDLE_VALUE;
+	}
+
+	// Return whatever is buffered, else wait for the first byte and return it
+	// at once, giving up empty after CAPTURE_READ_TIMEOUT_MS
+	timeouts.ReadIntervalTimeout = MAXDWORD;
+	timeouts.ReadTotalTimeoutConstant = CAPTURE_READ_TIMEOUT_MS;
+	timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+	timeouts.WriteTotalTimeoutConstant = 10;
+	timeouts.WriteTotalTimeoutMultiplier = 0;
+
+	if (!SetCommTimeouts(hComPort, &timeouts)) {
+		fprintf(stderr, "Error: Failed to set COM port timeouts.\n");
+		CloseHandle(hComPort);
+		return INVALID_HANDLE_VALUE;
+	}
+
+	fprintf(stderr, "Port initialised...\n");
+
+	return hComPort;
+}
+
+static void StopCapture(HANDLE hComPort)
+{
+	// Close the COM port
+	if (hComPort != INVALID_HANDLE_VALUE) {
+		CloseHandle(hComPort);
+		hComPort = INVALID_HANDLE_VALUE;
+	}
+}
+
+void CAPTURE_ListPorts(void)
+{
+	SP_DEVINFO_DATA devData;
+	size_t Total = 0;
+	DWORD i;
+
+	// Get a list of all COM ports
+	HDEVINFO hDevInfo = SetupDiGetClassDevs(&GUID_DEVCLASS_PORTS, 0, 0, DIGCF_PRESENT);
+	if (hDevInfo == INVALID_HANDLE_VALUE) {
+		printf("Error: Failed to get device information.\n");
+		return;
+	}
+
+	devData.cbSize = sizeof(SP_DEVINFO_DATA);
+
+	// Enumerate all COM ports
+	for (i = 0; SetupDiEnumDeviceInfo(hDevInfo, i, &devData); i++) {
+		char friendlyName[256] = { 0 };
+		DWORD dataType = 0;
+		DWORD size = sizeof(friendlyName);
+
+		// Get the friendly name of the device
+		if (SetupDiGetDeviceRegistryProperty(hDevInfo, &devData, SPDRP_FRIENDLYNAME,
+			&dataType, (PBYTE)friendlyName, size, &size)) {
+			std::string portName = friendlyName;
+			size_t startPos = portName.find("(COM");
+			size_t endPos = portName.find(")", startPos);
+
+			if (startPos != std::string::npos && endPos != std::string::npos) {
+				std::string comPort = portName.substr(startPos + 1, endPos - startPos - 1);
+				printf("-> %s\n", comPort.c_str());
+				Total++;
+			}
+		}
+	}
+
+	SetupDiDestroyDeviceInfoList(hDevInfo);
+
+	if (!Total) {
+		printf("No COM ports found.\n");
+	}
+}
+
+bool CAPTURE_Run(const CapturePort_t *pPorts, size_t Count, CaptureHandler_t pHandler)
+{
+	HANDLE hComPorts[CAPTURE_MAX_PORTS];
+	size_t i;
+
+	if (!Count || Count > CAPTURE_MAX_PORTS) {
+		return false;
+	}
+	// One wait handle is the stop event
+	if (Count >= MAXIMUM_WAIT_OBJECTS) {
+		fprintf(stderr, "Error: At most %d ports can be captured.\n", MAXIMUM_WAIT_OBJECTS - 1);
+		return false;
+	}
+
+	if (!ghStop) {
+		ghStop = CreateEvent(NULL, TRUE, FALSE, NULL);
+		if (!ghStop) {
+			fprintf(stderr, "Error: Failed to create the stop event (%d).\n", GetLastError());
+			return false;
+		}
+	}
+	// A stop that came before the event existed
+	if (gbStop) {
+		SetEvent(ghStop);
+	}
+
+	for (i = 0; i < Count; i++) {
+		hComPorts[i] = StartCapture(pPorts[i].pName);
+		if (hComPorts[i] == INVALID_HANDLE_VALUE) {
+			while (i--) {
+				StopCapture(hComPorts[i]);
+			}
+			return false;
+		}
+	}
+
+	Capture(hComPorts, pPorts, Count, pHandler);
+
+	for (i = 0; i < Count; i++) {
+		StopCapture(hComPorts[i]);
+	}
+
+	fprintf(stderr, "Stopped capturing data.\n");
+
+	return true;
+}
+
+void CAPTURE_SetConsole(bool bConsole)
+{
+	gbConsole = bConsole;
+}
+
+void CAPTURE_Stop(void)
+{
+	gbStop = true;
+	if (ghStop) {
+		SetEvent(ghStop);
+	}
+}
+
+#endif
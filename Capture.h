@@ -0,0 +1,44 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum {
+	CAPTURE_MAX_PORTS = 64,
+};
+
+// Timestamp is CLOCK_GetMonotonic() taken as soon as the read returned
+typedef void (*CaptureHandler_t)(void *pContext, const uint8_t *pBytes, size_t Length, uint64_t Timestamp);
+
+typedef struct CapturePort_t {
+	const char *pName;
+	void *pContext;
+} CapturePort_t;
+
+void CAPTURE_ListPorts(void);
+bool CAPTURE_Run(const CapturePort_t *pPorts, size_t Count, CaptureHandler_t pHandler);
+// A key press ends the capture unless the console is off, then only
+// CAPTURE_Stop() does
+void CAPTURE_SetConsole(bool bConsole);
+// Safe to call from a signal handler, before or during CAPTURE_Run()
+void CAPTURE_Stop(void);
+
+#endif
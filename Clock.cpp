@@ -0,0 +1,104 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+#include <string.h>
+#include <time.h>
+#include "Clock.h"
+#include "Platform.h"
+
+uint64_t CLOCK_GetMonotonic(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER Frequency;
+	LARGE_INTEGER Counter;
+
+	if (!Frequency.QuadPart) {
+		QueryPerformanceFrequency(&Frequency);
+	}
+	QueryPerformanceCounter(&Counter);
+
+	return (uint64_t)(Counter.QuadPart / Frequency.QuadPart) * 1000000000ULL
+		+ (uint64_t)(Counter.QuadPart % Frequency.QuadPart) * 1000000000ULL / (uint64_t)Frequency.QuadPart;
+#else
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (uint64_t)Now.tv_sec * 1000000000ULL + (uint64_t)Now.tv_nsec;
+#endif
+}
+
+uint64_t CLOCK_GetRealtime(void)
+{
+#ifdef _WIN32
+	FILETIME Time;
+	ULARGE_INTEGER Ticks;
+
+	GetSystemTimePreciseAsFileTime(&Time);
+	Ticks.LowPart = Time.dwLowDateTime;
+	Ticks.HighPart = Time.dwHighDateTime;
+
+	// FILETIME counts 100ns ticks from 1601-01-01
+	return (Ticks.QuadPart - 116444736000000000ULL) * 100ULL;
+#else
+	struct timespec Now;
+
+	clock_gettime(CLOCK_REALTIME, &Now);
+
+	return (uint64_t)Now.tv_sec * 1000000000ULL + (uint64_t)Now.tv_nsec;
+#endif
+}
+
+size_t CLOCK_Format(ClockText_t *pCache, uint64_t Realtime, char *pText, size_t TextLength)
+{
+	const uint64_t Second = Realtime / 1000000000ULL;
+	unsigned Milliseconds = (unsigned)(Realtime % 1000000000ULL / 1000000ULL);
+	char *pEnd;
+
+	// The timezone conversion is by far the slowest part, only redo it once
+	// per second
+	if (!pCache->Length || pCache->Second != Second) {
+		struct tm TimeInfo;
+		time_t Now = (time_t)Second;
+
+		localtime_s(&TimeInfo, &Now);
+		pCache->Length = strftime(pCache->Prefix, sizeof(pCache->Prefix), "[%Y-%m-%d %H:%M:%S.", &TimeInfo);
+		pCache->Second = Second;
+	}
+
+	if (TextLength < pCache->Length + 6) {
+		if (TextLength) {
+			pText[0] = 0;
+		}
+		return 0;
+	}
+
+	memcpy(pText, pCache->Prefix, pCache->Length);
+	pEnd = pText + pCache->Length;
+	pEnd[2] = (char)('0' + Milliseconds % 10);
+	Milliseconds /= 10;
+	pEnd[1] = (char)('0' + Milliseconds % 10);
+	pEnd[0] = (char)('0' + Milliseconds / 10);
+	pEnd[3] = ']';
+	pEnd[4] = ' ';
+	pEnd[5] = 0;
+
+	return pCache->Length + 5;
+}
@@ -0,0 +1,37 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Calendar part of the last rendered time, reused until the second changes
+typedef struct ClockText_t {
+	uint64_t Second;
+	size_t Length;
+	char Prefix[32];
+} ClockText_t;
+
+// Nanoseconds from an arbitrary origin, never goes backwards
+uint64_t CLOCK_GetMonotonic(void);
+// Nanoseconds since the Unix epoch
+uint64_t CLOCK_GetRealtime(void);
+// Renders "[YYYY-MM-DD HH:MM:SS.mmm] " in local time, returns its length
+size_t CLOCK_Format(ClockText_t *pCache, uint64_t Realtime, char *pText, size_t TextLength);
+
+#endif
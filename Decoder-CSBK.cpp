@@ -14,257 +14,142 @@
  *     limitations under the License.
  */
 
-#include <stdio.h>
-#include <string.h>
 #include "BitStream.h"
 #include "Decoder-CSBK.h"
-#include "Decoder-internal.h"
-#include "Helpers.h"
-
-static bool DecodeAloha(char *pText, size_t TextLength, BitStream_t *pBs)
-{
-	bool bTsccas;
-	bool bSync;
-	uint8_t Version;
-	bool bOffset;
-	bool bActive;
-	uint8_t Mask;
-	uint8_t Service;
-	uint8_t NRand;
-	bool bReg;
-	uint8_t Backoff;
-	uint16_t Code;
-	uint32_t MsAddress;
-
-	BS_PopUInt(pBs, 1, &bTsccas, sizeof(bTsccas));
-	BS_PopUInt(pBs, 1, &bSync, sizeof(bSync));
-	BS_PopUInt(pBs, 3, &Version, sizeof(Version));
-	BS_PopUInt(pBs, 1, &bOffset, sizeof(bOffset));
-	BS_PopUInt(pBs, 1, &bActive, sizeof(bActive));
-	BS_PopUInt(pBs, 5, &Mask, sizeof(Mask));
-	BS_PopUInt(pBs, 2, &Service, sizeof(Service));
-	BS_PopUInt(pBs, 4, &NRand, sizeof(NRand));
-	BS_PopUInt(pBs, 1, &bReg, sizeof(bReg));
-	BS_PopUInt(pBs, 4, &Backoff, sizeof(Backoff));
-	BS_PopUInt(pBs, 16, &Code, sizeof(Code));
-	if (!BS_PopUInt(pBs, 24, &MsAddress, sizeof(MsAddress))) {
-		strcat_s(pText, TextLength, "Aloha: Incomplete CSBK!");
-		return true;
-	}
-
-	pText[0] = 0;
-	//sprintf_s(pText, TextLength, "Aloha: Code %d MS Address %d", Code, MsAddress);
-
-	return false; // This CSBK is too noisy
-}
-
-static bool DecodePvGrant(char *pText, size_t TextLength, BitStream_t *pBs)
-{
-	uint16_t Lpcn;
-	uint8_t Lcn;
-	bool bEmergency;
-	bool bOffset;
-	uint32_t Ta, Sa;
-
-	BS_PopUInt(pBs, 12, &Lpcn, sizeof(Lpcn));
-	BS_PopUInt(pBs, 1, &Lcn, sizeof(Lcn));
-	BS_SkipBits(pBs, 1); // Reserved
-	BS_PopUInt(pBs, 1, &bEmergency, sizeof(bEmergency));
-	BS_PopUInt(pBs, 1, &bOffset, sizeof(bOffset));
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	if (!BS_PopUInt(pBs, 24, &Sa, sizeof(Sa))) {
-		strcat_s(pText, TextLength, "Private Voice Grant: Incomplete CSBK!");
-		return true;
-	}
-
-	sprintf_s(pText, TextLength, "Private Voice Grant: %sfrom %d to %d on Channel %d TS%d", bEmergency ? "Emergency " : "", Sa, Ta, Lpcn, Lcn + 1);
-
-	return true;
-}
-
-static bool DecodeTvGrant(char *pText, size_t TextLength, BitStream_t *pBs)
-{
-	uint16_t Lpcn;
-	uint8_t Lcn;
-	bool bLateEntry;
-	bool bEmergency;
-	bool bOffset;
-	uint32_t Ta, Sa;
-
-	BS_PopUInt(pBs, 12, &Lpcn, sizeof(Lpcn));
-	BS_PopUInt(pBs, 1, &Lcn, sizeof(Lcn));
-	BS_PopUInt(pBs, 1, &bLateEntry, sizeof(bLateEntry));
-	BS_PopUInt(pBs, 1, &bEmergency, sizeof(bEmergency));
-	BS_PopUInt(pBs, 1, &bOffset, sizeof(bOffset));
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	if (!BS_PopUInt(pBs, 24, &Sa, sizeof(Sa))) {
-		strcat_s(pText, TextLength, "Talkroup Voice Grant: Incomplete CSBK!");
-		return true;
-	}
-
-	sprintf_s(pText, TextLength, "Talkroup Voice Grant: %sfrom %d to %d on Channel %d TS%d", bEmergency ? "Emergency " : "", Sa, Ta, Lpcn, Lcn + 1);
-
-	return true;
-}
-
-static bool DecodeBtvGrant(char *pText, size_t TextLength, BitStream_t *pBs)
-{
-	uint16_t Lpcn;
-	uint8_t Lcn;
-	bool bLateEntry;
-	bool bEmergency;
-	bool bOffset;
-	uint32_t Ta, Sa;
-
-	BS_PopUInt(pBs, 12, &Lpcn, sizeof(Lpcn));
-	BS_PopUInt(pBs, 1, &Lcn, sizeof(Lcn));
-	BS_PopUInt(pBs, 1, &bLateEntry, sizeof(bLateEntry));
-	BS_PopUInt(pBs, 1, &bEmergency, sizeof(bEmergency));
-	BS_PopUInt(pBs, 1, &bOffset, sizeof(bOffset));
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	if (!BS_PopUInt(pBs, 24, &Sa, sizeof(Sa))) {
-		strcat_s(pText, TextLength, "Broadcast Voice Grant: Incomplete CSBK!");
-		return true;
-	}
-
-	sprintf_s(pText, TextLength, "Broadcast Voice Grant: %sfrom %d to %d on Channel %d TS%d", bEmergency ? "Emergency " : "", Sa, Ta, Lpcn, Lcn + 1);
-
-	return true;
-}
-
-static bool DecodeAhoy(char *pText, size_t TextLength, BitStream_t *pBs)
+#include "Decoder-Internal.h"
+#include "Decoder-Layout.h"
+#include "Event.h"
+#include "Filter.h"
+
+// Bodies are the 8 bytes after the opcode and feature set
+static const LayoutField_t kAloha[] = {
+	LAYOUT_FIELD(Aloha.bTsccas, 0, 1),
+	LAYOUT_FIELD(Aloha.bSync, 1, 1),
+	LAYOUT_FIELD(Aloha.Version, 2, 3),
+	LAYOUT_FIELD(Aloha.bOffset, 5, 1),
+	LAYOUT_FIELD(Aloha.bActive, 6, 1),
+	LAYOUT_FIELD(Aloha.Mask, 7, 5),
+	LAYOUT_FIELD(Aloha.Service, 12, 2),
+	LAYOUT_FIELD(Aloha.NRand, 14, 4),
+	LAYOUT_FIELD(Aloha.bReg, 18, 1),
+	LAYOUT_FIELD(Aloha.Backoff, 19, 4),
+	LAYOUT_FIELD(Aloha.Code, 23, 16),
+	LAYOUT_FIELD(Aloha.MsAddress, 39, 24),
+};
+
+// Bit 13 is reserved in private grants
+static const LayoutField_t kPvGrant[] = {
+	LAYOUT_FIELD(Grant.Channel, 0, 12),
+	LAYOUT_FIELD_BIAS(Grant.Slot, 12, 1, 1),
+	LAYOUT_FIELD(Grant.bEmergency, 14, 1),
+	LAYOUT_FIELD(Grant.bOffset, 15, 1),
+	LAYOUT_FIELD(Grant.Target, 16, 24),
+	LAYOUT_FIELD(Grant.Source, 40, 24),
+};
+
+static const LayoutField_t kGrant[] = {
+	LAYOUT_FIELD(Grant.Channel, 0, 12),
+	LAYOUT_FIELD_BIAS(Grant.Slot, 12, 1, 1),
+	LAYOUT_FIELD(Grant.bLateEntry, 13, 1),
+	LAYOUT_FIELD(Grant.bEmergency, 14, 1),
+	LAYOUT_FIELD(Grant.bOffset, 15, 1),
+	LAYOUT_FIELD(Grant.Target, 16, 24),
+	LAYOUT_FIELD(Grant.Source, 40, 24),
+};
+
+static const LayoutField_t kAhoy[] = {
+	LAYOUT_FIELD(Ahoy.Service, 0, 7),
+	LAYOUT_FIELD(Ahoy.bFlag, 7, 1),
+	LAYOUT_FIELD(Ahoy.bAmbient, 8, 1),
+	LAYOUT_FIELD(Ahoy.bGroup, 9, 1),
+	LAYOUT_FIELD(Ahoy.Blocks, 10, 2),
+	LAYOUT_FIELD(Ahoy.Kind, 12, 4),
+	LAYOUT_FIELD(Ahoy.Target, 16, 24),
+	LAYOUT_FIELD(Ahoy.Source, 40, 24),
+};
+
+static const LayoutField_t kCAckD[] = {
+	LAYOUT_FIELD(Ackd.Response, 0, 7),
+	LAYOUT_FIELD(Ackd.Reason, 7, 8),
+	LAYOUT_FIELD(Ackd.Target, 16, 24),
+	LAYOUT_FIELD(Ackd.Source, 40, 24),
+};
+
+static const LayoutField_t kCBcast[] = {
+	LAYOUT_FIELD(Bcast.Kind, 0, 5),
+	LAYOUT_FIELD(Bcast.Params1, 5, 14),
+	LAYOUT_FIELD(Bcast.bReg, 19, 1),
+	LAYOUT_FIELD(Bcast.Backoff, 20, 4),
+	LAYOUT_FIELD(Bcast.Code, 24, 16),
+	LAYOUT_FIELD(Bcast.Params2, 40, 24),
+};
+
+static const LayoutField_t kPProtect[] = {
+	LAYOUT_FIELD(Protect.Kind, 12, 3),
+	LAYOUT_FIELD(Protect.bGroup, 15, 1),
+	LAYOUT_FIELD(Protect.Target, 16, 24),
+	LAYOUT_FIELD(Protect.Source, 40, 24),
+};
+
+// Other opcodes are dumped raw
+static const Layout_t kLayouts[] = {
+	LAYOUT(0x19, EVENT_ALOHA, 64, kAloha),
+	LAYOUT(0x30, EVENT_PV_GRANT, 64, kPvGrant),
+	LAYOUT(0x31, EVENT_TV_GRANT, 64, kGrant),
+	LAYOUT(0x32, EVENT_BTV_GRANT, 64, kGrant),
+	LAYOUT(0x1C, EVENT_AHOY, 64, kAhoy),
+	LAYOUT(0x20, EVENT_C_ACKD, 64, kCAckD),
+	LAYOUT(0x28, EVENT_C_BCAST, 64, kCBcast),
+	LAYOUT(0x2F, EVENT_P_PROTECT, 64, kPProtect),
+};
+
+bool CSBK_Decode(Event_t *pEvent, Decoder_t *pDecoder)
 {
-	uint8_t Mirror;
-	bool bFlag;
-	bool bAmbient;
-	bool bGroup;
-	uint8_t Blocks;
-	uint8_t Kind;
-	uint32_t Ta, Sa;
-
-	BS_PopUInt(pBs, 7, &Mirror, sizeof(Mirror));
-	BS_PopUInt(pBs, 1, &bFlag, sizeof(bFlag));
-	BS_PopUInt(pBs, 1, &bAmbient, sizeof(bAmbient));
-	BS_PopUInt(pBs, 1, &bGroup, sizeof(bGroup));
-	BS_PopUInt(pBs, 2, &Blocks, sizeof(Blocks));
-	BS_PopUInt(pBs, 4, &Kind, sizeof(Kind));
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	if (!BS_PopUInt(pBs, 24, &Sa, sizeof(Sa))) {
-		strcat_s(pText, TextLength, "AHOY: Incomplete CSBK!");
-		return true;
-	}
-
-	sprintf_s(pText, TextLength, "AHOY: From %d to %d, Service %d, Kind %d", Sa, Ta, Mirror, Kind);
-
-	return true;
-}
-
-static bool DecodeCAckD(char *pText, size_t TextLength, BitStream_t *pBs)
-{
-	uint8_t Response;
-	uint8_t Reason;
-	uint32_t Ta, Sa;
-
-	BS_PopUInt(pBs, 7, &Response, sizeof(Response));
-	BS_PopUInt(pBs, 8, &Reason, sizeof(Reason));
-	BS_SkipBits(pBs, 1);
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	if (!BS_PopUInt(pBs, 24, &Sa, sizeof(Sa))) {
-		strcat_s(pText, TextLength, "C_ACKD: Incomplete CSBK!");
-		return true;
-	}
-
-	sprintf_s(pText, TextLength, "C_ACKD: From %d to %d, Response %d Reason %d", Sa, Ta, Response, Reason);
-
-	return true;
-}
-
-static bool DecodeCBcast(char *pText, size_t TextLength, BitStream_t *pBs)
-{
-	uint8_t Type;
-	uint16_t Params1;
-	bool bReg;
-	uint8_t Backoff;
-	uint16_t Code;
-	uint32_t Params2;
-
-	BS_PopUInt(pBs, 5, &Type, sizeof(Type));
-	BS_PopUInt(pBs, 14, &Params1, sizeof(Params1));
-	BS_PopUInt(pBs, 1, &bReg, sizeof(bReg));
-	BS_PopUInt(pBs, 4, &Backoff, sizeof(Backoff));
-	BS_PopUInt(pBs, 16, &Code, sizeof(Code));
-	if (!BS_PopUInt(pBs, 24, &Params2, sizeof(Params2))) {
-		strcat_s(pText, TextLength, "C_BCAST: Incomplete CSBK!");
-		return true;
-	}
-
-	sprintf_s(pText, TextLength, "C_BCAST: Type %d Code %d, Params (0x%X, 0x%X)", Type, Code, Params1, Params2);
-
-	return true;
-}
-
-static bool DecodePProtect(char *pText, size_t TextLength, BitStream_t *pBs)
-{
-	uint8_t Kind;
-	bool bGroup;
-	uint32_t Ta, Sa;
-	const char *pKind;
-
-	BS_SkipBits(pBs, 12);
-	BS_PopUInt(pBs, 3, &Kind, sizeof(Kind));
-	BS_PopUInt(pBs, 1, &bGroup, sizeof(bGroup));
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	if (!BS_PopUInt(pBs, 24, &Sa, sizeof(Sa))) {
-		strcat_s(pText, TextLength, "Channel Protect: Incomplete CSBK!");
-		return true;
-	}
-
-	switch (Kind) {
-	case 0: pKind = "Disable PTT"; break;
-	case 1: pKind = "Enable PTT"; break;
-	case 2: pKind = "Illegally parked"; break;
-	case 3: pKind = "Enable PTT for Target only"; break;
-	default: pKind = "Reserved"; break;
-	}
-
-	sprintf_s(pText, TextLength, "Channel Protect: From %d to %d, Kind: %s", Sa, Ta, pKind);
-
-	return true;
-}
-
-bool CSBK_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder)
-{
-	uint8_t LastBlock;
-	uint8_t PrivateFlag;
-	uint8_t Opcode;
+	uint8_t Opcode = 0;
+	uint8_t Fid = 0;
+	const Layout_t *pLayout;
 	const uint8_t *pCsbk;
+	size_t Available;
 	size_t Length;
 
 	BS_PopUInt(&pDecoder->Bs, 8, &Length, sizeof(Length));
 	if (Length < 10) {
-		strcat_s(pText, TextLength, "Incomplete CSBK!");
+		pEvent->Type = EVENT_CSBK;
+		pEvent->Flags |= EVENT_INCOMPLETE;
+		pDecoder->Stats.IncompleteCsbks++;
 		return true;
 	}
 
 	pCsbk = BS_GetCurrentPtr(&pDecoder->Bs);
+	Available = BS_GetRemainingBytes(&pDecoder->Bs);
 
-	BS_PopUInt(&pDecoder->Bs, 1, &LastBlock, sizeof(LastBlock));
-	BS_PopUInt(&pDecoder->Bs, 1, &PrivateFlag, sizeof(PrivateFlag));
-	BS_PopUInt(&pDecoder->Bs, 6, &Opcode, sizeof(Opcode));
-	BS_SkipBits(&pDecoder->Bs, 8);
+	if (BS_Need(&pDecoder->Bs, 8)) {
+		BS_ExtractBits(&pDecoder->Bs, 2); // Last block and private flags
+		Opcode = (uint8_t)BS_ExtractBits(&pDecoder->Bs, 6);
+	}
+	if (BS_Need(&pDecoder->Bs, 8)) {
+		Fid = (uint8_t)BS_ExtractBits(&pDecoder->Bs, 8);
+	}
+	pEvent->Opcode = Opcode;
+	pDecoder->Stats.Csbks[Opcode]++;
+	if (pDecoder->pFilter && !FILTER_AcceptCsbk(pDecoder->pFilter, Opcode, Fid)) {
+		BS_SkipBytes(&pDecoder->Bs, BS_GetRemainingBytes(&pDecoder->Bs));
+		return false;
+	}
 
-	switch (Opcode) {
-	case 0x19: return DecodeAloha(pText, TextLength, &pDecoder->Bs);
-	case 0x30: return DecodePvGrant(pText, TextLength, &pDecoder->Bs);
-	case 0x31: return DecodeTvGrant(pText, TextLength, &pDecoder->Bs);
-	case 0x32: return DecodeBtvGrant(pText, TextLength, &pDecoder->Bs);
-	case 0x1C: return DecodeAhoy(pText, TextLength, &pDecoder->Bs);
-	case 0x20: return DecodeCAckD(pText, TextLength, &pDecoder->Bs);
-	case 0x28: return DecodeCBcast(pText, TextLength, &pDecoder->Bs);
-	case 0x2F: return DecodePProtect(pText, TextLength, &pDecoder->Bs);
-	default:
-		HEX_Append(pText, TextLength, "CSBK", pCsbk, Length);
-		BS_SkipBytes(&pDecoder->Bs, 8); // We already popped 2 bytes
+	pLayout = LAYOUT_Find(kLayouts, sizeof(kLayouts) / sizeof(kLayouts[0]), Opcode);
+	if (pLayout) {
+		pEvent->Type = pLayout->Type;
+		if (!LAYOUT_Extract(pLayout, &pDecoder->Bs, pEvent)) {
+			pDecoder->Stats.IncompleteCsbks++;
+		}
 		return true;
 	}
+
+	// The dump must not run past the end of the frame
+	pEvent->Type = EVENT_CSBK;
+	pEvent->pData = pCsbk;
+	pEvent->Length = Length < Available ? Length : Available;
+	BS_SkipBytes(&pDecoder->Bs, 8); // We already popped 2 bytes
+	return true;
 }
@@ -21,7 +21,8 @@
 #include <stdint.h>
 
 typedef struct Decoder_t Decoder_t;
+typedef struct Event_t Event_t;
 
-bool CSBK_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder);
+bool CSBK_Decode(Event_t *pEvent, Decoder_t *pDecoder);
 
 #endif
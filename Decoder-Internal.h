@@ -19,16 +19,49 @@
 
 #include "BitStream.h"
 #include "Decoder.h"
+#include "Filter.h"
+
+typedef struct DecoderMark_t {
+	uint64_t End;
+	uint64_t Timestamp;
+} DecoderMark_t;
+
+// Talker alias being put together from its header and blocks, one per
+// timeslot. Length counts the bits still expected.
+typedef struct DecoderAlias_t {
+	uint8_t Previous;
+	uint8_t Format;
+	uint8_t Bits;
+	uint8_t Index;
+	uint16_t Length;
+	uint16_t Surrogate;
+	char Text[EVENT_MAX_ALIAS];
+} DecoderAlias_t;
 
 typedef struct Decoder_t {
 	BitStream_t Bs;
-	size_t Length, RPos, WPos, FPos, DataLength, FrameLength;
-	uint8_t State;
+	size_t Length, RPos, WPos;
+	const uint8_t *pInput;
+	size_t InputLength;
+	const uint8_t *pFrame;
+	size_t FrameLength, Offset;
+	uint64_t InputTimestamp, Timestamp;
+	// Bytes ever queued and consumed, the marks tell when queued bytes arrived
+	uint64_t Queued, Consumed;
+	DecoderMark_t Marks[DECODER_MAX_MARKS];
+	size_t MarkHead, MarkCount;
 	bool bTs;
+	bool bLostSync;
+	bool bRaw;
+	const Filter_t *pFilter;
 	uint8_t Cc;
+	DecoderAlias_t Aliases[2];
 	char Text[128];
-	uint8_t Frame[ANYTONE_MAX_FRAME_LENGTH];
-	uint8_t Buffer[1024];
+	DecoderOverflow_t Policy;
+	DecoderStats_t Stats;
+	// The head of the ring is mirrored past its end so every frame is contiguous
+	size_t Size;
+	uint8_t *pBuffer;
 } Decoder_t;
 
 #endif
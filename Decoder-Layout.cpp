@@ -0,0 +1,65 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "BitStream.h"
+#include "Decoder-Layout.h"
+
+// Public
+
+const Layout_t *LAYOUT_Find(const Layout_t *pLayouts, size_t Count, uint8_t Opcode)
+{
+	size_t i;
+
+	for (i = 0; i < Count; i++) {
+		if (pLayouts[i].Opcode == Opcode) {
+			return &pLayouts[i];
+		}
+	}
+
+	return NULL;
+}
+
+bool LAYOUT_Extract(const Layout_t *pLayout, BitStream_t *pBs, Event_t *pEvent)
+{
+	uint8_t *pBase = (uint8_t *)pEvent;
+	uint64_t Body;
+	size_t i;
+
+	if (!BS_Need(pBs, pLayout->Bits)) {
+		pEvent->Flags |= EVENT_INCOMPLETE;
+		BS_SkipBytes(pBs, BS_GetRemainingBytes(pBs));
+		return false;
+	}
+
+	// Left aligned, so every field is a shift pair away
+	Body = BS_ExtractBits(pBs, 32) << 32;
+	Body |= BS_ExtractBits(pBs, pLayout->Bits - 32U) << (64U - pLayout->Bits);
+
+	for (i = 0; i < pLayout->Count; i++) {
+		const LayoutField_t *pField = &pLayout->pFields[i];
+		uint64_t Value = ((Body << pField->Offset) >> (64U - pField->Width)) + pField->Bias;
+		uint8_t *pMember = pBase + pField->Member;
+		size_t j;
+
+		// Same byte order as BS_PopUInt()
+		for (j = 0; j < pField->Size; j++) {
+			pMember[j] = (uint8_t)Value;
+			Value >>= 8;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,59 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef DECODER_LAYOUT_H
+#define DECODER_LAYOUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Event.h"
+
+typedef struct BitStream_t BitStream_t;
+
+// A field of a fixed length body and the Event_t member it fills. Offsets
+// count bits from the first bit of the body.
+typedef struct LayoutField_t {
+	uint8_t Offset;
+	uint8_t Width;
+	uint8_t Size;
+	uint8_t Bias; // Added to the value, for fields numbered from 1
+	uint16_t Member;
+} LayoutField_t;
+
+typedef struct Layout_t {
+	uint8_t Opcode;
+	EventType_t Type;
+	uint8_t Bits; // Length of the body, 33 to 64 bits
+	const LayoutField_t *pFields;
+	size_t Count;
+} Layout_t;
+
+#define LAYOUT_FIELD(Name, Offset, Width) \
+	{ Offset, Width, sizeof(((Event_t *)0)->Name), 0, offsetof(Event_t, Name) }
+#define LAYOUT_FIELD_BIAS(Name, Offset, Width, Bias) \
+	{ Offset, Width, sizeof(((Event_t *)0)->Name), Bias, offsetof(Event_t, Name) }
+#define LAYOUT(Opcode, Type, Bits, Fields) \
+	{ Opcode, Type, Bits, Fields, sizeof(Fields) / sizeof((Fields)[0]) }
+
+const Layout_t *LAYOUT_Find(const Layout_t *pLayouts, size_t Count, uint8_t Opcode);
+
+// Loads the whole body in one go and fills every field from it. A short body
+// marks the event incomplete, drops the rest of the frame and returns false.
+bool LAYOUT_Extract(const Layout_t *pLayout, BitStream_t *pBs, Event_t *pEvent);
+
+#endif
@@ -14,101 +14,175 @@
  *     limitations under the License.
  */
 
-#include <stdio.h>
-#include <string.h>
 #include "BitStream.h"
 #include "Decoder-Internal.h"
+#include "Decoder-Layout.h"
 #include "Decoder-Voice.h"
-#include "Helpers.h"
+#include "Event.h"
+#include "Filter.h"
 
-static bool DecodeGroup(char *pText, size_t TextLength, bool bTs, const char *pType, BitStream_t *pBs)
+// The 7 bytes after the opcode and feature set
+static const LayoutField_t kCall[] = {
+	LAYOUT_FIELD(Lc.Options, 0, 8),
+	LAYOUT_FIELD(Lc.Target, 8, 24),
+	LAYOUT_FIELD(Lc.Source, 32, 24),
+};
+
+// Group and private calls share their layout, the type and opcode are
+// already set by the LC header
+static const Layout_t kCallLayout = LAYOUT(0, EVENT_NONE, 56, kCall);
+
+static bool DecodeCall(Event_t *pEvent, BitStream_t *pBs)
 {
-	uint8_t Options;
-	uint32_t Ta, Sa;
+	LAYOUT_Extract(&kCallLayout, pBs, pEvent);
 
-	BS_PopU8(pBs, &Options);
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	BS_PopUInt(pBs, 24, &Sa, sizeof(Sa));
+	return true;
+}
 
-	sprintf_s(pText, TextLength, "TS%d Group call %sfrom %d to %d", bTs + 1, pType, Sa, Ta);
+// Other opcodes are kept raw, starting from the length byte
+static bool DecodeRaw(Event_t *pEvent, const uint8_t *pData, size_t Length, size_t Available, BitStream_t *pBs)
+{
+	if (Length > Available) {
+		Length = Available;
+	}
+	pEvent->pData = pData;
+	pEvent->Length = Length;
+	BS_SkipBytes(pBs, Length);
 
 	return true;
 }
 
-static bool DecodePrivate(char *pText, size_t TextLength, bool bTs, const char *pType, BitStream_t *pBs)
+static void AppendUtf8(DecoderAlias_t *pAlias, uint32_t Code)
 {
-	uint8_t Options;
-	uint32_t Ta, Sa;
+	char *pText = pAlias->Text + pAlias->Index;
+	size_t Count;
 
-	BS_PopU8(pBs, &Options);
-	BS_PopUInt(pBs, 24, &Ta, sizeof(Ta));
-	BS_PopUInt(pBs, 24, &Sa, sizeof(Sa));
+	if (Code < 0x80) {
+		Count = 1;
+	} else if (Code < 0x800) {
+		Count = 2;
+	} else if (Code < 0x10000) {
+		Count = 3;
+	} else {
+		Count = 4;
+	}
+	// Keep room for the terminator
+	if (pAlias->Index + Count >= sizeof(pAlias->Text)) {
+		return;
+	}
 
-	sprintf_s(pText, TextLength, "TS%d Private call %sfrom %d to %d", bTs + 1, pType, Sa, Ta);
+	switch (Count) {
+	case 1:
+		pText[0] = (char)Code;
+		break;
+	case 2:
+		pText[0] = (char)(0xC0 | (Code >> 6));
+		pText[1] = (char)(0x80 | (Code & 0x3F));
+		break;
+	case 3:
+		pText[0] = (char)(0xE0 | (Code >> 12));
+		pText[1] = (char)(0x80 | ((Code >> 6) & 0x3F));
+		pText[2] = (char)(0x80 | (Code & 0x3F));
+		break;
+	default:
+		pText[0] = (char)(0xF0 | (Code >> 18));
+		pText[1] = (char)(0x80 | ((Code >> 12) & 0x3F));
+		pText[2] = (char)(0x80 | ((Code >> 6) & 0x3F));
+		pText[3] = (char)(0x80 | (Code & 0x3F));
+		break;
+	}
+	pAlias->Index += (uint8_t)Count;
+}
 
-	return true;
+// Surrogate pairs may straddle two blocks, unpaired halves become U+FFFD
+static void AppendUtf16(DecoderAlias_t *pAlias, uint16_t Unit)
+{
+	if (Unit >= 0xD800 && Unit < 0xDC00) {
+		if (pAlias->Surrogate) {
+			AppendUtf8(pAlias, 0xFFFD);
+		}
+		pAlias->Surrogate = Unit;
+		return;
+	}
+	if (Unit >= 0xDC00 && Unit < 0xE000) {
+		if (pAlias->Surrogate) {
+			AppendUtf8(pAlias, 0x10000 + ((uint32_t)(pAlias->Surrogate - 0xD800) << 10) + (Unit - 0xDC00));
+			pAlias->Surrogate = 0;
+		} else {
+			AppendUtf8(pAlias, 0xFFFD);
+		}
+		return;
+	}
+	if (pAlias->Surrogate) {
+		AppendUtf8(pAlias, 0xFFFD);
+		pAlias->Surrogate = 0;
+	}
+	AppendUtf8(pAlias, Unit);
+}
+
+// Takes as many characters as the header or block holds. UTF-16 aliases are
+// kept as UTF-8, the others byte for byte.
+static void PopChars(DecoderAlias_t *pAlias, BitStream_t *pBs)
+{
+	while (pAlias->Length >= pAlias->Bits && BS_Need(pBs, pAlias->Bits)) {
+		const uint32_t Char = (uint32_t)BS_ExtractBits(pBs, pAlias->Bits);
+
+		pAlias->Length -= pAlias->Bits;
+		if (pAlias->Bits == 16) {
+			AppendUtf16(pAlias, (uint16_t)Char);
+		} else if (pAlias->Index + 1U < sizeof(pAlias->Text)) {
+			pAlias->Text[pAlias->Index++] = (char)Char;
+		}
+	}
+	if (!pAlias->Length && pAlias->Surrogate) {
+		AppendUtf8(pAlias, 0xFFFD);
+		pAlias->Surrogate = 0;
+	}
+	pAlias->Text[pAlias->Index] = 0;
 }
 
-static bool DecodeTalker(char *pText, size_t TextLength, bool bTs, uint8_t Type, BitStream_t *pBs)
+static bool DecodeTalker(Event_t *pEvent, DecoderAlias_t *pAlias, uint8_t Type, BitStream_t *pBs)
 {
-	static uint8_t Previous[2] = { 0xFF, 0xFF };
-	static uint8_t Format[2];
-	static uint8_t Bits[2];
-	static uint8_t Length[2];
-	static uint8_t Index[2];
-	static char Alias[2][64];
+	static const uint8_t kBits[4] = { 7, 8, 8, 16 };
 
 	switch (Type) {
 	case 4:
-		Index[bTs] = 0;
-		BS_PopUInt(pBs, 2, Format + bTs, sizeof(Format[bTs]));
-		BS_PopUInt(pBs, 5, Length + bTs, sizeof(Length[bTs]));
-		if (Format[bTs] == 3) {
-			Previous[bTs] = 0xFF;
-			strcat_s(pText, TextLength, "UTF-16 not yet supported!");
-			return true;
-		}
-		Bits[bTs] = (Format[bTs] == 0) ? 7 : 8;
-		if (Bits[bTs] == 8) {
+		pAlias->Index = 0;
+		pAlias->Surrogate = 0;
+		BS_PopUInt(pBs, 2, &pAlias->Format, sizeof(pAlias->Format));
+		BS_PopUInt(pBs, 5, &pAlias->Length, sizeof(pAlias->Length));
+		pAlias->Bits = kBits[pAlias->Format & 3];
+		if (pAlias->Bits != 7) {
 			BS_SkipBits(pBs, 1);
 		}
-		Length[bTs] *= Bits[bTs];
-		if (!Length[bTs]) {
+		pAlias->Length *= pAlias->Bits;
+		if (!pAlias->Length) {
 			Type = 0xFF;
 			break;
 		}
-		while (Length[bTs] >= Bits[bTs] && !BS_Eof(pBs)) {
-			if (BS_PopBits(pBs, Bits[bTs], Alias[bTs] + Index[bTs], 1)) {
-				Index[bTs]++;
-				Length[bTs] -= Bits[bTs];
-			}
-		}
-		Alias[bTs][Index[bTs]] = 0;
+		PopChars(pAlias, pBs);
 		break;
 
 	case 5:
 	case 6:
 	case 7:
-		if ((Previous[bTs] + 1) == Type) {
-			if (!Length[bTs] || !Bits[bTs]) {
+		if ((pAlias->Previous + 1) == Type) {
+			if (!pAlias->Length || !pAlias->Bits) {
 				Type = 0xFF;
 				break;
 			}
-			while (Length[bTs] >= Bits[bTs] && !BS_Eof(pBs)) {
-				if (BS_PopBits(pBs, Bits[bTs], Alias[bTs] + Index[bTs], 1)) {
-					Index[bTs]++;
-					Length[bTs] -= Bits[bTs];
-				}
-			}
-			Alias[bTs][Index[bTs]] = 0;
+			PopChars(pAlias, pBs);
 		}
 		break;
 	}
-	Previous[bTs] = Type;
-	if (!Length[bTs] && Index[bTs]) {
-		sprintf_s(pText, TextLength, "TS%d TA(%d): %s", bTs + 1, Format[bTs], Alias[bTs]);
-		Index[bTs] = 0;
-		Previous[bTs] = 0xFF;
+	pAlias->Previous = Type;
+	if (!pAlias->Length && pAlias->Index) {
+		pEvent->Type = EVENT_TALKER_ALIAS;
+		pEvent->Alias.Format = pAlias->Format;
+		pEvent->Alias.pText = pAlias->Text;
+		pEvent->Alias.Length = pAlias->Index;
+		pAlias->Index = 0;
+		pAlias->Previous = 0xFF;
 
 		return true;
 	}
@@ -116,18 +190,19 @@ static bool DecodeTalker(char *pText, size_t TextLength, bool bTs, uint8_t Type,
 	return false;
 }
 
-bool VOICE_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder)
+bool VOICE_Decode(Event_t *pEvent, Decoder_t *pDecoder)
 {
 	uint8_t Private;
 	uint8_t R;
-	uint8_t Opcode;
-	uint8_t Fid;
 	const uint8_t *pData = BS_GetCurrentPtr(&pDecoder->Bs);
+	const size_t Available = BS_GetRemainingBytes(&pDecoder->Bs);
 	size_t Length;
 
+	pEvent->Type = EVENT_VOICE_LC;
+
 	BS_PopUInt(&pDecoder->Bs, 8, &Length, sizeof(Length));
 	if (Length < 9) {
-		strcat_s(pText, TextLength, "Incomplete Voice LC Header!");
+		pEvent->Flags |= EVENT_INCOMPLETE;
 		return true;
 	}
 	if (Length > 9) {
@@ -136,33 +211,36 @@ bool VOICE_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder)
 
 	BS_PopUInt(&pDecoder->Bs, 1, &Private, sizeof(Private));
 	BS_PopUInt(&pDecoder->Bs, 1, &R, sizeof(R));
-	BS_PopUInt(&pDecoder->Bs, 6, &Opcode, sizeof(Opcode));
-	BS_PopU8(&pDecoder->Bs, &Fid);
+	BS_PopUInt(&pDecoder->Bs, 6, &pEvent->Opcode, sizeof(pEvent->Opcode));
+	BS_PopU8(&pDecoder->Bs, &pEvent->Lc.Fid);
+	if (pDecoder->pFilter && !FILTER_AcceptFid(pDecoder->pFilter, pEvent->Lc.Fid)) {
+		BS_SkipBytes(&pDecoder->Bs, BS_GetRemainingBytes(&pDecoder->Bs));
+		return false;
+	}
 
-	switch (Opcode) {
-	case 0: return DecodeGroup(pText, TextLength, pDecoder->bTs, "", &pDecoder->Bs);
-	case 3: return DecodePrivate(pText, TextLength, pDecoder->bTs, "", &pDecoder->Bs);
+	switch (pEvent->Opcode) {
+	case 0: case 3:
+		return DecodeCall(pEvent, &pDecoder->Bs);
 	case 4: case 5: case 6: case 7:
-		return DecodeTalker(pText, TextLength, pDecoder->bTs, Opcode, &pDecoder->Bs);
+		return DecodeTalker(pEvent, &pDecoder->Aliases[pDecoder->bTs], pEvent->Opcode, &pDecoder->Bs);
 	default:
-		HEX_Append(pText, TextLength, "VOICE_LC:", pData, Length);
-		BS_SkipBytes(&pDecoder->Bs, Length);
-		return true;
+		return DecodeRaw(pEvent, pData, Length, Available, &pDecoder->Bs);
 	}
 }
 
-bool TERM_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder)
+bool TERM_Decode(Event_t *pEvent, Decoder_t *pDecoder)
 {
 	uint8_t Private;
 	uint8_t R;
-	uint8_t Opcode;
-	uint8_t Fid;
 	const uint8_t *pData = BS_GetCurrentPtr(&pDecoder->Bs);
+	const size_t Available = BS_GetRemainingBytes(&pDecoder->Bs);
 	size_t Length;
 
+	pEvent->Type = EVENT_TERM_LC;
+
 	BS_PopUInt(&pDecoder->Bs, 8, &Length, sizeof(Length));
 	if (Length < 9) {
-		strcat_s(pText, TextLength, "Incomplete Term LC Header!");
+		pEvent->Flags |= EVENT_INCOMPLETE;
 		return true;
 	}
 	if (Length > 9) {
@@ -171,15 +249,17 @@ bool TERM_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder)
 
 	BS_PopUInt(&pDecoder->Bs, 1, &Private, sizeof(Private));
 	BS_PopUInt(&pDecoder->Bs, 1, &R, sizeof(R));
-	BS_PopUInt(&pDecoder->Bs, 6, &Opcode, sizeof(Opcode));
-	BS_PopU8(&pDecoder->Bs, &Fid);
+	BS_PopUInt(&pDecoder->Bs, 6, &pEvent->Opcode, sizeof(pEvent->Opcode));
+	BS_PopU8(&pDecoder->Bs, &pEvent->Lc.Fid);
+	if (pDecoder->pFilter && !FILTER_AcceptFid(pDecoder->pFilter, pEvent->Lc.Fid)) {
+		BS_SkipBytes(&pDecoder->Bs, BS_GetRemainingBytes(&pDecoder->Bs));
+		return false;
+	}
 
-	switch (Opcode) {
-	case 0: return DecodeGroup(pText, TextLength, pDecoder->bTs, "ended ", &pDecoder->Bs);
-	case 3: return DecodePrivate(pText, TextLength, pDecoder->bTs, "ended ", &pDecoder->Bs);
+	switch (pEvent->Opcode) {
+	case 0: case 3:
+		return DecodeCall(pEvent, &pDecoder->Bs);
 	default:
-		HEX_Append(pText, TextLength, "TERM_LC:", pData, Length);
-		BS_SkipBytes(&pDecoder->Bs, Length);
-		return true;
+		return DecodeRaw(pEvent, pData, Length, Available, &pDecoder->Bs);
 	}
 }
@@ -21,8 +21,9 @@
 #include <stdint.h>
 
 typedef struct Decoder_t Decoder_t;
+typedef struct Event_t Event_t;
 
-bool VOICE_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder);
-bool TERM_Decode(char *pText, size_t TextLength, Decoder_t *pDecoder);
+bool VOICE_Decode(Event_t *pEvent, Decoder_t *pDecoder);
+bool TERM_Decode(Event_t *pEvent, Decoder_t *pDecoder);
 
 #endif
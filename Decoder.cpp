@@ -17,258 +17,625 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DECODER_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
 #include "BitStream.h"
 #include "Decoder.h"
 #include "Decoder-CSBK.h"
 #include "Decoder-Voice.h"
-#include "Decoder-internal.h"
+#include "Decoder-Internal.h"
+#include "Event.h"
 #include "Helpers.h"
 
 static const uint8_t kMagic[3] = { 0x84, 0xA9, 0x61 };
 
 // Private
 
-static bool DecodeDmrCc(Decoder_t *pDecoder, char *pText, size_t TextLength)
+static bool DecodeDmrCc(Decoder_t *pDecoder)
+{
+	// Only sets the colour code shown with the following bursts
+	BS_PopU8(&pDecoder->Bs, &pDecoder->Cc);
+
+	return false;
+}
+
+static bool DecodeDigcDataFrame(Decoder_t *pDecoder, Event_t *pEvent)
 {
-	if (!BS_PopU8(&pDecoder->Bs, &pDecoder->Cc)) {
+	bool bBurst = false;
+	size_t Skip;
+
+	if (BS_Need(&pDecoder->Bs, 8)) {
+		pDecoder->bTs = BS_ExtractBits(&pDecoder->Bs, 1) != 0;
+		BS_ExtractBits(&pDecoder->Bs, 2);
+		bBurst = BS_ExtractBits(&pDecoder->Bs, 1) != 0;
+		pEvent->DataType = (uint8_t)BS_ExtractBits(&pDecoder->Bs, 4);
+	}
+
+	pEvent->Ts = pDecoder->bTs + 1;
+	pEvent->Cc = pDecoder->Cc;
+	if (bBurst) {
+		pEvent->Flags |= EVENT_VOICE;
+	}
+	if (pDecoder->pFilter && !FILTER_AcceptBurst(pDecoder->pFilter, pEvent->Ts, pEvent->Cc, pEvent->DataType)) {
+		BS_SkipBytes(&pDecoder->Bs, BS_GetRemainingBytes(&pDecoder->Bs));
 		return false;
 	}
 
-	sprintf_s(pText, TextLength, "CC%02d", pDecoder->Cc);
+	switch (pEvent->DataType) {
+	case 1: return VOICE_Decode(pEvent, pDecoder);
+	case 2: return TERM_Decode(pEvent, pDecoder);
+	case 3: return CSBK_Decode(pEvent, pDecoder);
+	}
 
-	return false;
+	Skip = BS_GetRemainingBytes(&pDecoder->Bs);
+	pEvent->Type = EVENT_BURST;
+	pEvent->pData = BS_GetCurrentPtr(&pDecoder->Bs);
+	pEvent->Length = Skip;
+	BS_SkipBytes(&pDecoder->Bs, Skip);
+
+	return true;
 }
 
-static bool DecodeDigcDataFrame(Decoder_t *pDecoder, char *pText, size_t TextLength)
+static bool DecodeCach(Decoder_t *pDecoder, Event_t *pEvent)
 {
-	const char *pType = NULL;
-	bool bRet = false;
-	bool bBurst;
-	uint8_t Type;
-	size_t Skip;
+	EventCach_t *pCach = &pEvent->Cach;
+
+	pEvent->Type = EVENT_CACH;
+
+	if (BS_Need(&pDecoder->Bs, 8)) {
+		pCach->bBsSync = BS_ExtractBits(&pDecoder->Bs, 1) != 0;
+		pCach->bSlotVerified = BS_ExtractBits(&pDecoder->Bs, 1) != 0;
+		pCach->bSlotChanged = BS_ExtractBits(&pDecoder->Bs, 1) != 0;
+		BS_ExtractBits(&pDecoder->Bs, 1);
+		pCach->bBusy = BS_ExtractBits(&pDecoder->Bs, 1) != 0;
+		pCach->Ts = (uint8_t)BS_ExtractBits(&pDecoder->Bs, 1);
+		pCach->Kind = (uint8_t)BS_ExtractBits(&pDecoder->Bs, 2);
+	}
+	pCach->Ts++;
 
-	BS_PopUInt(&pDecoder->Bs, 1, &pDecoder->bTs, sizeof(pDecoder->bTs));
-	BS_SkipBits(&pDecoder->Bs, 2);
-	BS_PopUInt(&pDecoder->Bs, 1, &bBurst, sizeof(bBurst));
-	BS_PopUInt(&pDecoder->Bs, 4, &Type, sizeof(Type));
+	return true;
+}
 
-	Skip = sprintf_s(pText, TextLength, "TS%d-C%02d: ", pDecoder->bTs + 1, pDecoder->Cc);
-	pText += Skip;
-	TextLength -= Skip;
+// One record of a frame, Id already popped
+static bool DecodeRecord(Decoder_t *pDecoder, uint8_t Id, Event_t *pEvent)
+{
+	switch (Id) {
+	case 0x43:
+		return DecodeDigcDataFrame(pDecoder, pEvent);
 
-	if (bBurst) {
-		strcat_s(pText, TextLength, "Voice Burst: ");
-	} else {
-		strcat_s(pText, TextLength, "Data Burst: ");
-	}
-
-	switch (Type) {
-	case 0: pType = "PI Header"; break;
-	case 1: bRet = VOICE_Decode(pText, TextLength, pDecoder); break;
-	case 2: bRet = TERM_Decode(pText, TextLength, pDecoder); break;
-	case 3: bRet = CSBK_Decode(pText, TextLength, pDecoder); break;
-	case 4: pType = "MBC Header"; break;
-	case 5: pType = "MBC Continuation"; break;
-	case 6: pType = "Data Header"; break;
-	case 7: pType = "Rate 1/2 Data"; break;
-	case 8: pType = "Rate 3/4 Data"; break;
-	case 9: pType = "Idle"; break;
-	case 10: pType = "Rate 1 Data"; break;
-	case 11: pType = "Reserved 11"; break;
-	case 12: pType = "Reserved 12"; break;
-	case 13: pType = "Reserved 13"; break;
-	case 14: pType = "Reserved 14"; break;
-	case 15: pType = "Reserved 15"; break;
-	}
-
-	if (pType) {
-		Skip = BS_GetRemainingBytes(&pDecoder->Bs);
-		HEX_Append(pText, TextLength, pType, BS_GetCurrentPtr(&pDecoder->Bs), Skip);
-		BS_SkipBytes(&pDecoder->Bs, Skip);
-		return true;
+	case 0x77:
+		return DecodeDmrCc(pDecoder);
+
+	case 0x7F:
+		return DecodeCach(pDecoder, pEvent);
+
+	default:
+		// Commands we currently don't care about are skipped unless asked for
+		if (pDecoder->bRaw) {
+			pEvent->Type = EVENT_COMMAND;
+			pEvent->Opcode = Id;
+			pEvent->pData = BS_GetCurrentPtr(&pDecoder->Bs);
+			pEvent->Length = BS_GetRemainingBytes(&pDecoder->Bs);
+		}
+		BS_SkipBytes(&pDecoder->Bs, BS_GetRemainingBytes(&pDecoder->Bs));
+		return pDecoder->bRaw;
 	}
+}
 
-	return bRet;
+#ifdef DECODER_SSE2
+static unsigned CountTrailingZeros(unsigned Mask)
+{
+#ifdef _MSC_VER
+	unsigned long Index;
+
+	_BitScanForward(&Index, Mask);
+
+	return (unsigned)Index;
+#else
+	return (unsigned)__builtin_ctz(Mask);
+#endif
 }
+#endif
 
-static bool DecodeCach(Decoder_t *pDecoder, char *pText, size_t TextLength)
+// Position of the first byte that can start the magic, or ScanLength. Only
+// the first two magic bytes are matched here, 16 positions at a time.
+static size_t FindMagic(const uint8_t *pBytes, size_t ScanLength, size_t Available)
 {
-	bool bBsSync;
-	bool bSlotVerified;
-	bool bSlotChanged;
-	bool bBusy;
-	bool bTs;
-	uint8_t Type;
+	size_t i = 0;
+
+#ifdef DECODER_SSE2
+	const __m128i First = _mm_set1_epi8((char)kMagic[0]);
+	const __m128i Second = _mm_set1_epi8((char)kMagic[1]);
 
-	BS_PopUInt(&pDecoder->Bs, 1, &bBsSync, sizeof(bBsSync));
-	BS_PopUInt(&pDecoder->Bs, 1, &bSlotVerified, sizeof(bSlotVerified));
-	BS_PopUInt(&pDecoder->Bs, 1, &bSlotChanged, sizeof(bSlotChanged));
-	BS_SkipBits(&pDecoder->Bs, 1);
-	BS_PopUInt(&pDecoder->Bs, 1, &bBusy, sizeof(bBusy));
-	BS_PopUInt(&pDecoder->Bs, 1, &bTs, sizeof(bTs));
-	BS_PopUInt(&pDecoder->Bs, 2, &Type, sizeof(Type));
+	while (i < ScanLength && i + 17 <= Available) {
+		const __m128i A = _mm_loadu_si128((const __m128i *)(pBytes + i));
+		const __m128i B = _mm_loadu_si128((const __m128i *)(pBytes + i + 1));
+		const unsigned Mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(A, First), _mm_cmpeq_epi8(B, Second)));
 
-	sprintf_s(pText, TextLength, "CACH: %s Sync", bBsSync ? "BS" : "MS");
-	if (bSlotVerified) {
-		strcat_s(pText, TextLength, ", Slot Verified");
+		if (Mask) {
+			i += CountTrailingZeros(Mask);
+			return i < ScanLength ? i : ScanLength;
+		}
+		i += 16;
 	}
-	if (bSlotChanged) {
-		strcat_s(pText, TextLength, ", Slot Changed");
+#endif
+
+	while (i < ScanLength) {
+		const uint8_t *pMagic = (const uint8_t *)memchr(pBytes + i, kMagic[0], ScanLength - i);
+
+		if (!pMagic) {
+			return ScanLength;
+		}
+		i = (size_t)(pMagic - pBytes);
+		if (i + 1 >= Available || pBytes[i + 1] == kMagic[1]) {
+			return i;
+		}
+		i++;
 	}
-	strcat_s(pText, TextLength, bBusy ? ", Inbound busy" : ", Inbound idle");
-	strcat_s(pText, TextLength, bTs ? ", Outbound TS2" : ", Outbound TS1");
-	if (bBsSync) {
-		switch (Type) {
-		case 0: strcat_s(pText, TextLength, ", Single/First fragment"); break;
-		case 1: strcat_s(pText, TextLength, ", First fragment"); break;
-		case 2: strcat_s(pText, TextLength, ", Last fragment"); break;
-		case 3: strcat_s(pText, TextLength, ", Continuing fragment"); break;
+
+	return ScanLength;
+}
+
+// Looks for the next frame in a contiguous span. The magic is only searched
+// within the first ScanLength bytes but the frame itself may extend up to
+// Available. Returns the number of bytes to discard before the candidate and
+// sets *pFrameLength if the candidate is complete.
+static size_t FindFrame(const uint8_t *pBytes, size_t ScanLength, size_t Available, size_t *pFrameLength, DecoderStats_t *pStats)
+{
+	size_t i = 0;
+
+	*pFrameLength = 0;
+
+	for (;;) {
+		size_t DataLength;
+
+		i += FindMagic(pBytes + i, ScanLength - i, Available - i);
+		if (i >= ScanLength) {
+			return ScanLength;
 		}
-	} else {
-		switch (Type) {
-		case 0: strcat_s(pText, TextLength, ", No TDMA Sync"); break;
-		case 1: strcat_s(pText, TextLength, ", TS1 Sync"); break;
-		case 2: strcat_s(pText, TextLength, ", TS2 Sync"); break;
+
+		if (i + 2 < Available && pBytes[i + 2] != kMagic[2]) {
+			i++;
+			continue;
+		}
+		if (i + 5 > Available) {
+			return i;
+		}
+
+		DataLength = (pBytes[i + 3] << 8) | pBytes[i + 4];
+		if (DataLength % 2) {
+			DataLength++;
 		}
+		if (!DataLength || DataLength + 6 > ANYTONE_MAX_FRAME_LENGTH) {
+			pStats->BadLengths++;
+			i++;
+			continue;
+		}
+
+		if (i + 6 + DataLength <= Available) {
+			*pFrameLength = 6 + DataLength;
+		}
+
+		return i;
 	}
+}
+
+// Copies into the ring, keeping the mirror of its head up to date
+static void StoreBytes(Decoder_t *pDecoder, size_t Position, const uint8_t *pBytes, size_t Length)
+{
+	memcpy(pDecoder->pBuffer + Position, pBytes, Length);
+	if (Position < ANYTONE_MAX_FRAME_LENGTH) {
+		size_t Mirror = ANYTONE_MAX_FRAME_LENGTH - Position;
+
+		if (Mirror > Length) {
+			Mirror = Length;
+		}
+		memcpy(pDecoder->pBuffer + pDecoder->Size + Position, pBytes, Mirror);
+	}
+}
+
+static void ConsumeRing(Decoder_t *pDecoder, size_t Length)
+{
+	pDecoder->RPos = (pDecoder->RPos + Length) % pDecoder->Size;
+	pDecoder->Length -= Length;
+	pDecoder->Consumed += Length;
+}
+
+// Drops queued bytes to make room. Anything still queued after a
+// DECODER_Check() is the start of a frame, so this cuts that frame short.
+static void DropRing(Decoder_t *pDecoder, size_t Length)
+{
+	if (!Length) {
+		return;
+	}
+	if (pDecoder->pBuffer[pDecoder->RPos] == kMagic[0]) {
+		pDecoder->Stats.PartialFrames++;
+	}
+	pDecoder->Stats.BytesDropped += Length;
+	ConsumeRing(pDecoder, Length);
+}
+
+// Moves the queued bytes to the start of a new buffer of the given size
+static bool ResizeRing(Decoder_t *pDecoder, size_t Size)
+{
+	Decoder_t Old = *pDecoder;
+	size_t First;
+
+	pDecoder->pBuffer = (uint8_t *)malloc(Size + ANYTONE_MAX_FRAME_LENGTH);
+	if (!pDecoder->pBuffer) {
+		pDecoder->pBuffer = Old.pBuffer;
+		return false;
+	}
+	pDecoder->Size = Size;
+
+	if (Old.Length > Size) {
+		DropRing(&Old, Old.Length - Size);
+		pDecoder->Stats = Old.Stats;
+		pDecoder->Consumed = Old.Consumed;
+	}
+
+	First = Old.Size - Old.RPos;
+	if (First > Old.Length) {
+		First = Old.Length;
+	}
+	StoreBytes(pDecoder, 0, Old.pBuffer + Old.RPos, First);
+	StoreBytes(pDecoder, First, Old.pBuffer, Old.Length - First);
+
+	pDecoder->Length = Old.Length;
+	pDecoder->RPos = 0;
+	pDecoder->WPos = Old.Length % Size;
+	free(Old.pBuffer);
 
 	return true;
 }
 
+// Appends to the ring under the overflow policy, returns the bytes dropped
+static size_t QueueBytes(Decoder_t *pDecoder, const uint8_t *pBytes, size_t Length)
+{
+	size_t Dropped = 0;
+	size_t Free;
+	size_t Max;
+
+	if (pDecoder->Length + Length > pDecoder->Size && pDecoder->Policy == DECODER_GROW) {
+		size_t Size = pDecoder->Size;
+
+		while (Size < DECODER_MAX_BUFFER_SIZE && pDecoder->Length + Length > Size) {
+			Size *= 2;
+		}
+		if (Size > DECODER_MAX_BUFFER_SIZE) {
+			Size = DECODER_MAX_BUFFER_SIZE;
+		}
+		ResizeRing(pDecoder, Size);
+	}
+
+	Free = pDecoder->Size - pDecoder->Length;
+	if (Length > Free) {
+		// DropRing() counts the queued bytes it drops, the rest is counted here
+		if (pDecoder->Policy == DECODER_DROP_NEWEST) {
+			Dropped = Length - Free;
+			Length = Free;
+			pDecoder->Stats.BytesDropped += Dropped;
+			if (pDecoder->Length && pDecoder->pBuffer[pDecoder->RPos] == kMagic[0]) {
+				pDecoder->Stats.PartialFrames++;
+			}
+		} else if (Length >= pDecoder->Size) {
+			const size_t Skip = Length - pDecoder->Size;
+
+			Dropped = pDecoder->Length + Skip;
+			DropRing(pDecoder, pDecoder->Length);
+			pDecoder->Stats.BytesDropped += Skip;
+			pBytes += Skip;
+			Length = pDecoder->Size;
+		} else {
+			Dropped = Length - Free;
+			DropRing(pDecoder, Dropped);
+		}
+	}
+
+	Max = pDecoder->Size - pDecoder->WPos;
+	if (Max > Length) {
+		Max = Length;
+	}
+	StoreBytes(pDecoder, pDecoder->WPos, pBytes, Max);
+	StoreBytes(pDecoder, 0, pBytes + Max, Length - Max);
+	pDecoder->WPos = (pDecoder->WPos + Length) % pDecoder->Size;
+
+	pDecoder->Length += Length;
+	pDecoder->Queued += Length;
+	if (pDecoder->Stats.HighWater < pDecoder->Length) {
+		pDecoder->Stats.HighWater = pDecoder->Length;
+	}
+
+	return Dropped;
+}
+
+// Remembers when the bytes queued so far arrived
+static void AddMark(Decoder_t *pDecoder, uint64_t Timestamp)
+{
+	DecoderMark_t *pMark;
+
+	if (pDecoder->MarkCount) {
+		pMark = &pDecoder->Marks[(pDecoder->MarkHead + pDecoder->MarkCount - 1) % DECODER_MAX_MARKS];
+		// Once full, the newest mark absorbs the bytes, they only look older
+		if (pMark->Timestamp == Timestamp || pDecoder->MarkCount == DECODER_MAX_MARKS) {
+			pMark->End = pDecoder->Queued;
+			return;
+		}
+	}
+
+	pMark = &pDecoder->Marks[(pDecoder->MarkHead + pDecoder->MarkCount) % DECODER_MAX_MARKS];
+	pMark->End = pDecoder->Queued;
+	pMark->Timestamp = Timestamp;
+	pDecoder->MarkCount++;
+}
+
+// Arrival time of the queued byte just before End
+static uint64_t FindMark(Decoder_t *pDecoder, uint64_t End)
+{
+	while (pDecoder->MarkCount > 1 && pDecoder->Marks[pDecoder->MarkHead].End < End) {
+		pDecoder->MarkHead = (pDecoder->MarkHead + 1) % DECODER_MAX_MARKS;
+		pDecoder->MarkCount--;
+	}
+
+	if (!pDecoder->MarkCount) {
+		return pDecoder->InputTimestamp;
+	}
+
+	return pDecoder->Marks[pDecoder->MarkHead].Timestamp;
+}
+
+// Counts one resync per run of skipped bytes, not per skipped byte
+static void SkipBytes(Decoder_t *pDecoder, size_t Skip)
+{
+	if (!Skip) {
+		return;
+	}
+	if (!pDecoder->bLostSync) {
+		pDecoder->bLostSync = true;
+		pDecoder->Stats.Resyncs++;
+	}
+	pDecoder->Stats.BytesSkipped += Skip;
+}
+
+// Histogram bucket of a value, the bounds double from First
+static size_t GetBucket(uint64_t Value, uint64_t First, size_t Count)
+{
+	size_t i;
+
+	for (i = 0; i < Count - 1 && Value > First; i++) {
+		First *= 2;
+	}
+
+	return i;
+}
+
+static void SetFrame(Decoder_t *pDecoder, const uint8_t *pFrame, size_t FrameLength, uint64_t Timestamp)
+{
+	DecoderStats_t *pStats = &pDecoder->Stats;
+
+	pDecoder->pFrame = pFrame;
+	pDecoder->FrameLength = FrameLength;
+	pDecoder->Offset = 0;
+	pDecoder->bLostSync = false;
+
+	if (pStats->Frames) {
+		const uint64_t Gap = Timestamp > pDecoder->Timestamp ? Timestamp - pDecoder->Timestamp : 0;
+
+		pStats->GapNs += Gap;
+		pStats->Gaps[GetBucket(Gap, DECODER_FIRST_GAP_NS, DECODER_GAP_BUCKETS)]++;
+	}
+	pDecoder->Timestamp = Timestamp;
+	pStats->FrameBytes += FrameLength;
+	pStats->Sizes[GetBucket(FrameLength, DECODER_FIRST_SIZE, DECODER_SIZE_BUCKETS)]++;
+	pStats->Frames++;
+}
+
+// Returns true with a frame, false when the ring needs more bytes
+static bool CheckRing(Decoder_t *pDecoder)
+{
+	while (pDecoder->Length) {
+		size_t Scan = pDecoder->Size - pDecoder->RPos;
+		size_t Available = Scan + ANYTONE_MAX_FRAME_LENGTH;
+		size_t FrameLength;
+		size_t Skip;
+
+		if (Scan > pDecoder->Length) {
+			Scan = pDecoder->Length;
+		}
+		if (Available > pDecoder->Length) {
+			Available = pDecoder->Length;
+		}
+
+		Skip = FindFrame(pDecoder->pBuffer + pDecoder->RPos, Scan, Available, &FrameLength, &pDecoder->Stats);
+		SkipBytes(pDecoder, Skip);
+		ConsumeRing(pDecoder, Skip);
+
+		if (FrameLength) {
+			// Thanks to the mirror the frame is contiguous even across the wrap
+			SetFrame(pDecoder, pDecoder->pBuffer + pDecoder->RPos, FrameLength, FindMark(pDecoder, pDecoder->Consumed + FrameLength));
+			ConsumeRing(pDecoder, FrameLength);
+			return true;
+		}
+
+		if (Skip < Scan) {
+			return false;
+		}
+	}
+
+	return false;
+}
+
 // Public
 
 Decoder_t *DECODER_New(void)
 {
-	return (Decoder_t *)calloc(1, sizeof(Decoder_t));
+	Decoder_t *pDecoder = (Decoder_t *)calloc(1, sizeof(Decoder_t));
+
+	if (!pDecoder) {
+		return NULL;
+	}
+
+	pDecoder->Size = DECODER_BUFFER_SIZE;
+	pDecoder->pBuffer = (uint8_t *)malloc(DECODER_BUFFER_SIZE + ANYTONE_MAX_FRAME_LENGTH);
+	if (!pDecoder->pBuffer) {
+		free(pDecoder);
+		return NULL;
+	}
+	pDecoder->Aliases[0].Previous = 0xFF;
+	pDecoder->Aliases[1].Previous = 0xFF;
+
+	return pDecoder;
 }
 
-int DECODER_AddBytes(Decoder_t *pDecoder, const void *pBuffer, size_t Length)
+void DECODER_Free(Decoder_t *pDecoder)
 {
-	const uint8_t *pBytes = (const uint8_t *)pBuffer;
-	size_t Max;
-	bool bAdjustRPos = false;
+	if (pDecoder) {
+		free(pDecoder->pBuffer);
+		free(pDecoder);
+	}
+}
 
-	if (!pDecoder || Length > sizeof(pDecoder->Buffer)) {
-		return -1;
+bool DECODER_SetBuffer(Decoder_t *pDecoder, size_t Size, DecoderOverflow_t Policy)
+{
+	// A frame must always fit, and the mirror must never overlap itself
+	if (!pDecoder || Size < ANYTONE_MAX_FRAME_LENGTH || Size > DECODER_MAX_BUFFER_SIZE) {
+		return false;
 	}
 
-	Max = sizeof(pDecoder->Buffer) - pDecoder->WPos;
-	if (Length < Max) {
-		Max = Length;
-		Length = 0;
-	} else {
-		Length -= Max;
-	}
-	memcpy(pDecoder->Buffer + pDecoder->WPos, pBytes, Max);
-	pBytes += Max;
-	pDecoder->Length += Max;
-	if (pDecoder->Length > sizeof(pDecoder->Buffer)) {
-		pDecoder->Length = sizeof(pDecoder->Buffer);
-		bAdjustRPos = true;
-	}
-	if (Length) {
-		memcpy(pDecoder->Buffer, pBytes, Length);
-		pDecoder->WPos = Length;
-		pDecoder->Length += Length;
-	} else {
-		pDecoder->WPos = (pDecoder->WPos + Max) % sizeof(pDecoder->Buffer);
+	pDecoder->Policy = Policy;
+	if (Size == pDecoder->Size) {
+		return true;
 	}
 
-	if (bAdjustRPos) {
-		pDecoder->RPos = pDecoder->WPos;
-		pDecoder->State = 0;
-		pDecoder->FPos = 0;
+	return ResizeRing(pDecoder, Size);
+}
+
+void DECODER_SetRaw(Decoder_t *pDecoder, bool bRaw)
+{
+	pDecoder->bRaw = bRaw;
+}
+
+void DECODER_SetFilter(Decoder_t *pDecoder, const Filter_t *pFilter)
+{
+	pDecoder->pFilter = pFilter;
+}
+
+int DECODER_AddBytes(Decoder_t *pDecoder, const void *pBuffer, size_t Length, uint64_t Timestamp)
+{
+	size_t Dropped;
+
+	if (!pDecoder || (!pBuffer && Length)) {
+		return -1;
 	}
 
-	return 0;
+	pDecoder->Stats.BytesIn += Length;
+	Dropped = QueueBytes(pDecoder, (const uint8_t *)pBuffer, Length);
+	AddMark(pDecoder, Timestamp);
+
+	return Dropped ? 1 : 0;
+}
+
+void DECODER_Attach(Decoder_t *pDecoder, const void *pBuffer, size_t Length, uint64_t Timestamp)
+{
+	pDecoder->pInput = (const uint8_t *)pBuffer;
+	pDecoder->InputLength = Length;
+	pDecoder->InputTimestamp = Timestamp;
+	pDecoder->Stats.BytesIn += Length;
 }
 
 bool DECODER_Check(Decoder_t *pDecoder)
 {
-	uint16_t i;
-
-	for (i = 0; i < pDecoder->Length; i++) {
-		switch (pDecoder->State) {
-		case 0:
-		case 1:
-		case 2:
-			if (pDecoder->Buffer[pDecoder->RPos] == kMagic[pDecoder->State]) {
-				pDecoder->Frame[pDecoder->FPos++] = pDecoder->Buffer[pDecoder->RPos];
-				pDecoder->State++;
-			} else {
-				pDecoder->FPos = 0;
-				pDecoder->State = 0;
-				if (pDecoder->Buffer[pDecoder->RPos] == kMagic[0]) {
-					pDecoder->Frame[pDecoder->FPos++] = pDecoder->Buffer[pDecoder->RPos];
-					pDecoder->State++;
-				}
+	for (;;) {
+		size_t FrameLength;
+		size_t Skip;
+		size_t Move;
+
+		if (pDecoder->Length) {
+			if (CheckRing(pDecoder)) {
+				return true;
 			}
-			break;
-
-		case 3:
-			pDecoder->DataLength = pDecoder->Buffer[pDecoder->RPos] << 8;
-			pDecoder->Frame[pDecoder->FPos++] = pDecoder->Buffer[pDecoder->RPos];
-			pDecoder->State++;
-			break;
-
-		case 4:
-			pDecoder->DataLength |= pDecoder->Buffer[pDecoder->RPos];
-			pDecoder->Frame[pDecoder->FPos++] = pDecoder->Buffer[pDecoder->RPos];
-			if (pDecoder->DataLength % 2) {
-				pDecoder->DataLength++;
+			if (!pDecoder->Length) {
+				continue;
 			}
-			if (!pDecoder->DataLength || pDecoder->DataLength + 6 > sizeof(pDecoder->Frame)) {
-				pDecoder->State = 0;
-				pDecoder->FPos = 0;
-			} else {
-				pDecoder->State++;
-			}
-			break;
-
-		case 5:
-			pDecoder->Frame[pDecoder->FPos++] = pDecoder->Buffer[pDecoder->RPos];
-			pDecoder->State++;
-			break;
 
-		default:
-			pDecoder->Frame[pDecoder->FPos++] = pDecoder->Buffer[pDecoder->RPos];
-			pDecoder->DataLength--;
-			break;
+			// A frame straddles the end of what was queued and the attached
+			// buffer. Only then are attached bytes copied.
+			Move = pDecoder->Size - pDecoder->Length;
+			if (Move > ANYTONE_MAX_FRAME_LENGTH) {
+				Move = ANYTONE_MAX_FRAME_LENGTH;
+			}
+			if (Move > pDecoder->InputLength) {
+				Move = pDecoder->InputLength;
+			}
+			if (!Move) {
+				return false;
+			}
+			QueueBytes(pDecoder, pDecoder->pInput, Move);
+			AddMark(pDecoder, pDecoder->InputTimestamp);
+			pDecoder->pInput += Move;
+			pDecoder->InputLength -= Move;
+			continue;
 		}
 
-		pDecoder->RPos = (pDecoder->RPos + 1) % sizeof(pDecoder->Buffer);
+		if (!pDecoder->InputLength) {
+			return false;
+		}
 
-		if (pDecoder->State > 5 && !pDecoder->DataLength) {
-			pDecoder->FrameLength = pDecoder->FPos;
-			pDecoder->Length -= i + 1;
-			pDecoder->State = 0;
-			pDecoder->FPos = 0;
+		Skip = FindFrame(pDecoder->pInput, pDecoder->InputLength, pDecoder->InputLength, &FrameLength, &pDecoder->Stats);
+		SkipBytes(pDecoder, Skip);
+		pDecoder->pInput += Skip;
+		pDecoder->InputLength -= Skip;
 
+		if (FrameLength) {
+			SetFrame(pDecoder, pDecoder->pInput, FrameLength, pDecoder->InputTimestamp);
+			pDecoder->pInput += FrameLength;
+			pDecoder->InputLength -= FrameLength;
 			return true;
 		}
 
-		if (pDecoder->FPos == sizeof(pDecoder->Frame)) {
-			pDecoder->FPos = 0;
+		// Keep the start of a frame that continues in the next attached buffer
+		if (pDecoder->InputLength) {
+			QueueBytes(pDecoder, pDecoder->pInput, pDecoder->InputLength);
+			AddMark(pDecoder, pDecoder->InputTimestamp);
+			pDecoder->pInput += pDecoder->InputLength;
+			pDecoder->InputLength = 0;
 		}
+
+		return false;
 	}
+}
+
+const uint8_t *DECODER_GetFrame(Decoder_t *pDecoder, size_t *pLength)
+{
+	*pLength = pDecoder->FrameLength;
 
-	pDecoder->Length = 0;
+	return pDecoder->pFrame;
+}
 
-	return false;
+uint64_t DECODER_GetTimestamp(const Decoder_t *pDecoder)
+{
+	return pDecoder->Timestamp;
 }
 
-bool DECODER_GetText(Decoder_t *pDecoder, bool bSkip, char *pText, size_t TextLength)
+bool DECODER_GetEvent(Decoder_t *pDecoder, bool bSkip, Event_t *pEvent)
 {
 	uint16_t Length;
 	uint8_t PacketType;
 	uint8_t Id;
-	bool bPrint;
+	size_t Remaining;
+	bool bEvent;
 
-	if (!pDecoder || !pText || !TextLength || !pDecoder->FrameLength) {
+	if (!pDecoder || !pEvent || pDecoder->Offset >= pDecoder->FrameLength) {
 		return false;
 	}
 
-	BS_Init(&pDecoder->Bs, pDecoder->Frame, pDecoder->FrameLength);
+	// Records are walked in place, the frame is never copied or compacted
+	BS_Init(&pDecoder->Bs, pDecoder->pFrame + pDecoder->Offset, pDecoder->FrameLength - pDecoder->Offset);
 
 	if (!bSkip) {
 		BS_SkipBits(&pDecoder->Bs, 24); // Skip the magic bytes
@@ -277,48 +644,68 @@ bool DECODER_GetText(Decoder_t *pDecoder, bool bSkip, char *pText, size_t TextLe
 	}
 
 	if (!BS_PopU8(&pDecoder->Bs, &Id)) {
+		pDecoder->Offset = pDecoder->FrameLength;
 		return false;
 	}
 
-	pText[0] = 0;
+	memset(pEvent, 0, sizeof(*pEvent));
+	pDecoder->Stats.Commands[Id]++;
 
-	switch (Id) {
-	case 0x43:
-		bPrint = DecodeDigcDataFrame(pDecoder, pText, TextLength);
-		break;
-
-	case 0x77:
-		bPrint = DecodeDmrCc(pDecoder, pText, TextLength);
-		break;
-
-	case 0x7F:
-		bPrint = DecodeCach(pDecoder, pText, TextLength);
-		break;
-
-	default:
-#if 0 // Skip commands we currently don't care about
-.		sprintf_s(pText, TextLength, "Frame %02X", Id);
-		HEX_Append(pText, TextLength, "", BS_GetCurrentPtr(&pDecoder->Bs), BS_GetRemainingBytes(&pDecoder->Bs));
-		bPrint = true;
-#else
-		bPrint = false;
-#endif
+	// The colour code record only updates state, so it is always read
+	if (pDecoder->pFilter && Id != 0x77 && !FILTER_AcceptCommand(pDecoder->pFilter, Id)) {
 		BS_SkipBytes(&pDecoder->Bs, BS_GetRemainingBytes(&pDecoder->Bs));
-		break;
+		bEvent = false;
+	} else {
+		bEvent = DecodeRecord(pDecoder, Id, pEvent);
+	}
+	if (bEvent && pDecoder->pFilter && !FILTER_AcceptEvent(pDecoder->pFilter, pEvent)) {
+		bEvent = false;
 	}
 
-	pDecoder->FrameLength = BS_GetRemainingBytes(&pDecoder->Bs);
+	Remaining = BS_GetRemainingBytes(&pDecoder->Bs);
 	// Skip the potential padding byte
-	if (pDecoder->FrameLength <= 1) {
-		pDecoder->FrameLength = 0;
+	if (Remaining <= 1) {
+		pDecoder->Offset = pDecoder->FrameLength;
 	} else {
-		memcpy(pDecoder->Frame, BS_GetCurrentPtr(&pDecoder->Bs), pDecoder->FrameLength);
+		pDecoder->Offset = pDecoder->FrameLength - Remaining;
+	}
+
+	return bEvent;
+}
+
+bool DECODER_NextEvent(Decoder_t *pDecoder, Event_t *pEvent)
+{
+	for (;;) {
+		while (pDecoder->Offset < pDecoder->FrameLength) {
+			if (DECODER_GetEvent(pDecoder, pDecoder->Offset != 0, pEvent)) {
+				return true;
+			}
+		}
+		if (!DECODER_Check(pDecoder)) {
+			return false;
+		}
+	}
+}
+
+bool DECODER_GetText(Decoder_t *pDecoder, bool bSkip, char *pText, size_t TextLength)
+{
+	Event_t Event;
+
+	if (!pText || !TextLength || !DECODER_GetEvent(pDecoder, bSkip, &Event)) {
+		return false;
 	}
 
-	return bPrint;
+	return EVENT_FormatText(&Event, pText, TextLength) != 0;
 }
 
 size_t DECODER_GetFrameLength(Decoder_t *pDecoder)
 {
-	return pDecoder->FrameLength;
+	return pDecoder->FrameLength - pDecoder->Offset;
+}
+
+void DECODER_GetStats(const Decoder_t *pDecoder, DecoderStats_t *pStats)
+{
+	*pStats = pDecoder->Stats;
+	pStats->Pending = pDecoder->Length;
+	pStats->BufferSize = pDecoder->Size;
 }
@@ -19,18 +19,88 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "Event.h"
+#include "Filter.h"
 
 enum {
-	ANYTONE_MAX_FRAME_LENGTH = 330
+	ANYTONE_MAX_FRAME_LENGTH = 330,
+	DECODER_BUFFER_SIZE = 4096,
+	DECODER_MAX_BUFFER_SIZE = 1024 * 1024,
+	// Arrival times remembered for queued bytes, older ones are merged
+	DECODER_MAX_MARKS = 64,
+	// Histogram buckets, each bound twice the previous one and the last
+	// bucket unbounded: frames of up to 16, 32, ... 256 bytes and more, gaps
+	// between frames of up to 1, 2, ... 1024 ms and more
+	DECODER_SIZE_BUCKETS = 6,
+	DECODER_FIRST_SIZE = 16,
+	DECODER_GAP_BUCKETS = 12,
+	DECODER_FIRST_GAP_NS = 1000000,
 };
 
+// What DECODER_AddBytes() does when the queued bytes no longer fit
+typedef enum DecoderOverflow_t {
+	DECODER_GROW,        // Double the buffer up to DECODER_MAX_BUFFER_SIZE, then drop the oldest
+	DECODER_DROP_OLDEST, // Keep the newest bytes
+	DECODER_DROP_NEWEST, // Keep what is queued, refuse what does not fit
+} DecoderOverflow_t;
+
+typedef struct DecoderStats_t {
+	uint64_t BytesIn;
+	uint64_t BytesDropped;   // Lost to the overflow policy
+	uint64_t BytesSkipped;   // Discarded by the framer while looking for a magic
+	uint64_t Frames;
+	uint64_t Resyncs;        // Times the framer lost sync and had to skip bytes
+	uint64_t BadLengths;     // Magics rejected for a zero or oversize length field
+	uint64_t PartialFrames;  // Queued frame starts cut short by an overflow
+	size_t Pending;          // Bytes currently queued
+	size_t HighWater;        // Most bytes ever queued at once
+	size_t BufferSize;
+	uint64_t IncompleteCsbks; // CSBKs cut short by the end of their frame
+	uint64_t FrameBytes;      // Sum of the frame lengths
+	uint64_t GapNs;           // Sum of the gaps between frame arrivals
+	uint64_t Commands[256];   // Records per command id
+	uint64_t Csbks[64];       // CSBKs per opcode
+	uint64_t Sizes[DECODER_SIZE_BUCKETS];
+	uint64_t Gaps[DECODER_GAP_BUCKETS];
+} DecoderStats_t;
+
 typedef struct Decoder_t Decoder_t;
 
 Decoder_t *DECODER_New(void);
-int DECODER_AddBytes(Decoder_t *pDecoder, const void *pBuffer, size_t Length);
+void DECODER_Free(Decoder_t *pDecoder);
+// Resizes the input buffer, keeping the newest queued bytes
+bool DECODER_SetBuffer(Decoder_t *pDecoder, size_t Size, DecoderOverflow_t Policy);
+// Also report the records of every command id the decoders do not handle,
+// as EVENT_COMMAND with their raw bytes
+void DECODER_SetRaw(Decoder_t *pDecoder, bool bRaw);
+// Records the filter rejects are skipped as soon as the deciding field is
+// read. The filter is borrowed and NULL accepts everything.
+void DECODER_SetFilter(Decoder_t *pDecoder, const Filter_t *pFilter);
+// Queues any amount of bytes that arrived at Timestamp. Returns 1 if the
+// overflow policy had to drop bytes, 0 if everything was queued and -1 on
+// error.
+int DECODER_AddBytes(Decoder_t *pDecoder, const void *pBuffer, size_t Length, uint64_t Timestamp);
+// Frames straight out of a caller owned buffer that must outlive the decoding
+void DECODER_Attach(Decoder_t *pDecoder, const void *pBuffer, size_t Length, uint64_t Timestamp);
 bool DECODER_Check(Decoder_t *pDecoder);
+// Read-only view of the frame found by DECODER_Check(). It points into the
+// decoder ring or the attached buffer and stays valid until the next
+// DECODER_AddBytes(), DECODER_Attach() or DECODER_Check() call.
+const uint8_t *DECODER_GetFrame(Decoder_t *pDecoder, size_t *pLength);
+// Arrival time of the bytes that completed the current frame
+uint64_t DECODER_GetTimestamp(const Decoder_t *pDecoder);
+// Decodes the next record of the current frame, returns false if it does not
+// make an event. Pass bSkip for every record but the first.
+bool DECODER_GetEvent(Decoder_t *pDecoder, bool bSkip, Event_t *pEvent);
+// Walks every record of every queued or attached frame in one loop, calling
+// DECODER_Check() as needed. Returns false once the input is exhausted.
+// DECODER_GetFrame() and DECODER_GetTimestamp() still describe the frame the
+// event came from.
+bool DECODER_NextEvent(Decoder_t *pDecoder, Event_t *pEvent);
+// DECODER_GetEvent() rendered by EVENT_FormatText()
 bool DECODER_GetText(Decoder_t *pDecoder, bool bSkip, char *pText, size_t TextLength);
 size_t DECODER_GetFrameLength(Decoder_t *pDecoder);
+void DECODER_GetStats(const Decoder_t *pDecoder, DecoderStats_t *pStats);
 
 #endif
-
@@ -0,0 +1,254 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Dedup.h"
+
+#define DEDUP_TICK_NS	(DEDUP_TICK_MS * 1000000ULL)
+
+enum {
+	// Binary rendering of the largest event kept
+	DEDUP_RECORD = EVENT_BINARY_HEADER + 32 + DEDUP_MAX_RAW,
+};
+
+typedef struct DedupEntry_t {
+	uint64_t Key;      // 0 when free
+	uint64_t First;
+	uint64_t Last;
+	uint32_t Count;    // Copies folded since the first
+	uint8_t Port;
+	const char *pPort;
+	Event_t Event;
+	uint8_t Raw[DEDUP_MAX_RAW];
+} DedupEntry_t;
+
+struct Dedup_t {
+	DedupHandler_t pHandler;
+	void *pContext;
+	uint64_t Window;
+	uint64_t NextTick;
+	DedupStats_t Stats;
+	DedupEntry_t Sets[DEDUP_SETS][DEDUP_WAYS];
+};
+
+// Private
+
+// The control channel content the chip keeps reporting. Everything kept must
+// be rendered again from the entry, so raw bytes are bounded.
+static bool IsRepetitive(const Event_t *pEvent)
+{
+	switch (pEvent->Type) {
+	case EVENT_CACH:
+	case EVENT_CSBK:
+	case EVENT_ALOHA:
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+	case EVENT_AHOY:
+	case EVENT_C_ACKD:
+	case EVENT_C_BCAST:
+	case EVENT_P_PROTECT:
+		return pEvent->Length <= DEDUP_MAX_RAW;
+
+	default:
+		return false;
+	}
+}
+
+static uint64_t Mix(uint64_t Hash, uint64_t Word)
+{
+	Hash = (Hash ^ Word) * 0xFF51AFD7ED558CCDULL;
+
+	return Hash ^ (Hash >> 32);
+}
+
+// A word at a time, the renderings are a few dozen bytes
+static uint64_t Hash(const uint8_t *pData, size_t Length)
+{
+	uint64_t Hash = 0x9E3779B97F4A7C15ULL ^ Length;
+	uint64_t Word;
+
+	for (; Length >= 8; pData += 8, Length -= 8) {
+		memcpy(&Word, pData, 8);
+		Hash = Mix(Hash, Word);
+	}
+	if (Length) {
+		Word = 0;
+		memcpy(&Word, pData, Length);
+		Hash = Mix(Hash, Word);
+	}
+	Hash = Mix(Hash, 0xC4CEB9FE1A85EC53ULL);
+
+	// 0 marks a free entry
+	return Hash ? Hash : 1;
+}
+
+// The port and every field but the time
+static uint64_t GetKey(const Event_t *pEvent, const EventSource_t *pSource)
+{
+	uint8_t Record[DEDUP_RECORD];
+	EventSource_t Source = *pSource;
+
+	Source.Realtime = 0;
+
+	return Hash(Record, EVENT_FormatBinary(pEvent, &Source, Record, sizeof(Record)));
+}
+
+// Hands over the count, if there were repeats, and frees the entry
+static void Summarise(Dedup_t *pDedup, DedupEntry_t *pEntry)
+{
+	if (pEntry->Count) {
+		Event_t Summary = pEntry->Event;
+		EventSource_t Source;
+
+		Summary.Flags |= EVENT_REPEATED;
+		Summary.Repeats = pEntry->Count;
+		Source.Realtime = pEntry->Last;
+		Source.Port = pEntry->Port;
+		Source.pPort = pEntry->pPort;
+
+		pDedup->Stats.Summaries++;
+		pDedup->pHandler(pDedup->pContext, &Summary, &Source);
+	}
+	pEntry->Key = 0;
+}
+
+// Public
+
+Dedup_t *DEDUP_New(uint64_t Window, DedupHandler_t pHandler, void *pContext)
+{
+	Dedup_t *pDedup = (Dedup_t *)calloc(1, sizeof(Dedup_t));
+
+	if (!pDedup) {
+		return NULL;
+	}
+
+	pDedup->pHandler = pHandler;
+	pDedup->pContext = pContext;
+	pDedup->Window = Window;
+
+	return pDedup;
+}
+
+void DEDUP_Free(Dedup_t *pDedup)
+{
+	free(pDedup);
+}
+
+bool DEDUP_Add(Dedup_t *pDedup, const Event_t *pEvent, const EventSource_t *pSource)
+{
+	const uint64_t Now = pSource->Realtime;
+	DedupEntry_t *pEntry = NULL;
+	DedupEntry_t *pSet;
+	uint64_t Key;
+	size_t i;
+
+	if (!IsRepetitive(pEvent)) {
+		return false;
+	}
+	pDedup->Stats.Events++;
+
+	Key = GetKey(pEvent, pSource);
+	pSet = pDedup->Sets[Key & (DEDUP_SETS - 1)];
+	for (i = 0; i < DEDUP_WAYS; i++) {
+		if (pSet[i].Key == Key) {
+			pEntry = &pSet[i];
+			break;
+		}
+	}
+
+	if (pEntry) {
+		if (Now < pEntry->First + pDedup->Window) {
+			pEntry->Count++;
+			pEntry->Last = Now;
+			pDedup->Stats.Repeats++;
+			return true;
+		}
+		// The window is over, this copy is shown and starts the next one
+		Summarise(pDedup, pEntry);
+	} else {
+		// A free way, else the one quiet for the longest
+		pEntry = &pSet[0];
+		for (i = 0; i < DEDUP_WAYS; i++) {
+			if (!pSet[i].Key) {
+				pEntry = &pSet[i];
+				break;
+			}
+			if (pSet[i].Last < pEntry->Last) {
+				pEntry = &pSet[i];
+			}
+		}
+		if (pEntry->Key) {
+			pDedup->Stats.Evictions++;
+			Summarise(pDedup, pEntry);
+		}
+	}
+
+	pEntry->Key = Key;
+	pEntry->First = Now;
+	pEntry->Last = Now;
+	pEntry->Count = 0;
+	pEntry->Port = pSource->Port;
+	pEntry->pPort = pSource->pPort;
+	pEntry->Event = *pEvent;
+	if (pEvent->pData) {
+		memcpy(pEntry->Raw, pEvent->pData, pEvent->Length);
+		pEntry->Event.pData = pEntry->Raw;
+	}
+
+	return false;
+}
+
+void DEDUP_Expire(Dedup_t *pDedup, uint64_t Now)
+{
+	size_t i;
+	size_t j;
+
+	if (!Now || Now < pDedup->NextTick) {
+		return;
+	}
+	pDedup->NextTick = Now + DEDUP_TICK_NS;
+
+	for (i = 0; i < DEDUP_SETS; i++) {
+		for (j = 0; j < DEDUP_WAYS; j++) {
+			DedupEntry_t *pEntry = &pDedup->Sets[i][j];
+
+			if (pEntry->Key && Now >= pEntry->First + pDedup->Window) {
+				Summarise(pDedup, pEntry);
+			}
+		}
+	}
+}
+
+void DEDUP_Flush(Dedup_t *pDedup)
+{
+	size_t i;
+	size_t j;
+
+	for (i = 0; i < DEDUP_SETS; i++) {
+		for (j = 0; j < DEDUP_WAYS; j++) {
+			if (pDedup->Sets[i][j].Key) {
+				Summarise(pDedup, &pDedup->Sets[i][j]);
+			}
+		}
+	}
+}
+
+void DEDUP_GetStats(const Dedup_t *pDedup, DedupStats_t *pStats)
+{
+	*pStats = pDedup->Stats;
+}
@@ -0,0 +1,65 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Event.h"
+
+// Folds repeated CACH and CSBK events. The first copy is shown, copies with
+// the same content heard on the same port within the window after it are
+// only counted, and a summary with EVENT_REPEATED and the count follows once
+// the window is over. Events are keyed by a 64 bit hash of their binary
+// rendering without the time, in a set associative table that evicts, and
+// summarises, the stalest entry of a full set.
+enum {
+	DEDUP_SETS = 256,
+	DEDUP_WAYS = 4,
+	DEDUP_MAX_RAW = 16,   // Raw CSBK bytes kept for the summary
+	DEDUP_TICK_MS = 100,  // How often DEDUP_Expire() walks the table
+};
+
+// Receives each summary, the event is only valid during the call
+typedef void (*DedupHandler_t)(void *pContext, const Event_t *pSummary, const EventSource_t *pSource);
+
+typedef struct DedupStats_t {
+	uint64_t Events;
+	uint64_t Repeats;
+	uint64_t Summaries;
+	uint64_t Evictions;
+} DedupStats_t;
+
+typedef struct Dedup_t Dedup_t;
+
+// Window is in ns. Without a realtime, as in raw captures, windows never end
+// and summaries only come from evictions and DEDUP_Flush().
+Dedup_t *DEDUP_New(uint64_t Window, DedupHandler_t pHandler, void *pContext);
+void DEDUP_Free(Dedup_t *pDedup);
+
+// Returns true when the event repeats one shown less than a window ago and
+// needs no line of its own
+bool DEDUP_Add(Dedup_t *pDedup, const Event_t *pEvent, const EventSource_t *pSource);
+// Summarises the entries whose window ended before Now, a realtime in ns
+void DEDUP_Expire(Dedup_t *pDedup, uint64_t Now);
+// Summarises every entry, once the capture or replay is over
+void DEDUP_Flush(Dedup_t *pDedup);
+
+void DEDUP_GetStats(const Dedup_t *pDedup, DedupStats_t *pStats);
+
+#endif
@@ -0,0 +1,676 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "Event.h"
+#include "Helpers.h"
+
+static const char *const kDataTypes[16] = {
+	"PI Header",
+	"Voice LC Header",
+	"Terminator with LC",
+	"CSBK",
+	"MBC Header",
+	"MBC Continuation",
+	"Data Header",
+	"Rate 1/2 Data",
+	"Rate 3/4 Data",
+	"Idle",
+	"Rate 1 Data",
+	"Reserved 11",
+	"Reserved 12",
+	"Reserved 13",
+	"Reserved 14",
+	"Reserved 15",
+};
+
+static const char *const kProtectKinds[8] = {
+	"Disable PTT",
+	"Enable PTT",
+	"Illegally parked",
+	"Enable PTT for Target only",
+	"Reserved",
+	"Reserved",
+	"Reserved",
+	"Reserved",
+};
+
+static const char *const kCachBs[4] = {
+	", Single/First fragment",
+	", First fragment",
+	", Last fragment",
+	", Continuing fragment",
+};
+
+static const char *const kCachMs[4] = {
+	", No TDMA Sync",
+	", TS1 Sync",
+	", TS2 Sync",
+	"",
+};
+
+// Private
+
+static const char *GetName(EventType_t Type)
+{
+	switch (Type) {
+	case EVENT_CACH: return "cach";
+	case EVENT_BURST: return "burst";
+	case EVENT_CSBK: return "csbk";
+	case EVENT_ALOHA: return "aloha";
+	case EVENT_PV_GRANT: return "pv_grant";
+	case EVENT_TV_GRANT: return "tv_grant";
+	case EVENT_BTV_GRANT: return "btv_grant";
+	case EVENT_AHOY: return "ahoy";
+	case EVENT_C_ACKD: return "c_ackd";
+	case EVENT_C_BCAST: return "c_bcast";
+	case EVENT_P_PROTECT: return "p_protect";
+	case EVENT_VOICE_LC: return "voice_lc";
+	case EVENT_TERM_LC: return "term_lc";
+	case EVENT_TALKER_ALIAS: return "talker_alias";
+	case EVENT_COMMAND: return "command";
+	case EVENT_CALL: return "call";
+	default: return "none";
+	}
+}
+
+static const char *GetGrantName(EventType_t Type)
+{
+	switch (Type) {
+	case EVENT_PV_GRANT: return "Private Voice Grant";
+	case EVENT_TV_GRANT: return "Talkroup Voice Grant";
+	default: return "Broadcast Voice Grant";
+	}
+}
+
+// Sentences that report a problem or dump raw bytes follow the burst kind,
+// the others replace it
+static bool HasBurstLabel(const Event_t *pEvent)
+{
+	if (pEvent->Flags & EVENT_INCOMPLETE) {
+		return true;
+	}
+
+	switch (pEvent->Type) {
+	case EVENT_BURST:
+	case EVENT_CSBK:
+		return true;
+	case EVENT_VOICE_LC:
+	case EVENT_TERM_LC:
+		return pEvent->pData != NULL;
+	default:
+		return false;
+	}
+}
+
+static void FormatIncomplete(const Event_t *pEvent, char *pText, size_t TextLength)
+{
+	switch (pEvent->Type) {
+	case EVENT_ALOHA: strcat_s(pText, TextLength, "Aloha: Incomplete CSBK!"); break;
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+		strcat_s(pText, TextLength, GetGrantName(pEvent->Type));
+		strcat_s(pText, TextLength, ": Incomplete CSBK!");
+		break;
+	case EVENT_AHOY: strcat_s(pText, TextLength, "AHOY: Incomplete CSBK!"); break;
+	case EVENT_C_ACKD: strcat_s(pText, TextLength, "C_ACKD: Incomplete CSBK!"); break;
+	case EVENT_C_BCAST: strcat_s(pText, TextLength, "C_BCAST: Incomplete CSBK!"); break;
+	case EVENT_P_PROTECT: strcat_s(pText, TextLength, "Channel Protect: Incomplete CSBK!"); break;
+	case EVENT_VOICE_LC: strcat_s(pText, TextLength, "Incomplete Voice LC Header!"); break;
+	case EVENT_TERM_LC: strcat_s(pText, TextLength, "Incomplete Term LC Header!"); break;
+	default: strcat_s(pText, TextLength, "Incomplete CSBK!"); break;
+	}
+}
+
+static void FormatCach(const EventCach_t *pCach, char *pText, size_t TextLength)
+{
+	sprintf_s(pText, TextLength, "CACH: %s Sync", pCach->bBsSync ? "BS" : "MS");
+	if (pCach->bSlotVerified) {
+		strcat_s(pText, TextLength, ", Slot Verified");
+	}
+	if (pCach->bSlotChanged) {
+		strcat_s(pText, TextLength, ", Slot Changed");
+	}
+	strcat_s(pText, TextLength, pCach->bBusy ? ", Inbound busy" : ", Inbound idle");
+	strcat_s(pText, TextLength, pCach->Ts == 2 ? ", Outbound TS2" : ", Outbound TS1");
+	strcat_s(pText, TextLength, pCach->bBsSync ? kCachBs[pCach->Kind & 3] : kCachMs[pCach->Kind & 3]);
+}
+
+static void FormatCall(const Event_t *pEvent, char *pText, size_t TextLength)
+{
+	const EventCall_t *pCall = &pEvent->Call;
+	char Detail[96];
+
+	sprintf_s(pText, TextLength, "TS%u %s call from %u to %u, %.1f s",
+		pEvent->Ts, pCall->bPrivate ? "Private" : "Group", pCall->Source, pCall->Target,
+		(double)(pCall->End - pCall->Start) / 1e9);
+	if (pCall->bEmergency) {
+		strcat_s(pText, TextLength, ", Emergency");
+	}
+	if (pCall->bLateEntry) {
+		strcat_s(pText, TextLength, ", Late entry");
+	}
+	if (pCall->Channel) {
+		sprintf_s(Detail, sizeof(Detail), ", Channel %u TS%u", pCall->Channel, pCall->Slot);
+		strcat_s(pText, TextLength, Detail);
+	}
+	if (pCall->pAlias) {
+		sprintf_s(Detail, sizeof(Detail), ", TA(%u): %.*s", pCall->AliasFormat, (int)pCall->AliasLength, pCall->pAlias);
+		strcat_s(pText, TextLength, Detail);
+	}
+	if (!pCall->bEnded) {
+		strcat_s(pText, TextLength, ", no terminator");
+	}
+}
+
+// Renders the sentence of an event carried in a burst
+static bool FormatBurst(const Event_t *pEvent, char *pText, size_t TextLength)
+{
+	const EventLc_t *pLc = &pEvent->Lc;
+
+	if (pEvent->Flags & EVENT_INCOMPLETE) {
+		FormatIncomplete(pEvent, pText, TextLength);
+		return true;
+	}
+
+	switch (pEvent->Type) {
+	case EVENT_BURST:
+		HEX_Append(pText, TextLength, kDataTypes[pEvent->DataType & 15], pEvent->pData, pEvent->Length);
+		return true;
+
+	case EVENT_CSBK:
+		HEX_Append(pText, TextLength, "CSBK", pEvent->pData, pEvent->Length);
+		return true;
+
+	case EVENT_ALOHA:
+		sprintf_s(pText, TextLength, "ALOHA: MS %u, Version %u, Mask %u, Service %u, NRand %u, Backoff %u",
+			pEvent->Aloha.MsAddress, pEvent->Aloha.Version, pEvent->Aloha.Mask,
+			pEvent->Aloha.Service, pEvent->Aloha.NRand, pEvent->Aloha.Backoff);
+		return true;
+
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+		sprintf_s(pText, TextLength, "%s: %sfrom %u to %u on Channel %u TS%u",
+			GetGrantName(pEvent->Type), pEvent->Grant.bEmergency ? "Emergency " : "",
+			pEvent->Grant.Source, pEvent->Grant.Target, pEvent->Grant.Channel, pEvent->Grant.Slot);
+		return true;
+
+	case EVENT_AHOY:
+		sprintf_s(pText, TextLength, "AHOY: From %u to %u, Service %u, Kind %u",
+			pEvent->Ahoy.Source, pEvent->Ahoy.Target, pEvent->Ahoy.Service, pEvent->Ahoy.Kind);
+		return true;
+
+	case EVENT_C_ACKD:
+		sprintf_s(pText, TextLength, "C_ACKD: From %u to %u, Response %u Reason %u",
+			pEvent->Ackd.Source, pEvent->Ackd.Target, pEvent->Ackd.Response, pEvent->Ackd.Reason);
+		return true;
+
+	case EVENT_C_BCAST:
+		sprintf_s(pText, TextLength, "C_BCAST: Type %u Code %u, Params (0x%X, 0x%X)",
+			pEvent->Bcast.Kind, pEvent->Bcast.Code, pEvent->Bcast.Params1, pEvent->Bcast.Params2);
+		return true;
+
+	case EVENT_P_PROTECT:
+		sprintf_s(pText, TextLength, "Channel Protect: From %u to %u, Kind: %s",
+			pEvent->Protect.Source, pEvent->Protect.Target, kProtectKinds[pEvent->Protect.Kind & 7]);
+		return true;
+
+	case EVENT_VOICE_LC:
+	case EVENT_TERM_LC:
+		if (pEvent->pData) {
+			HEX_Append(pText, TextLength, pEvent->Type == EVENT_VOICE_LC ? "VOICE_LC:" : "TERM_LC:", pEvent->pData, pEvent->Length);
+		} else {
+			sprintf_s(pText, TextLength, "TS%u %s call %sfrom %u to %u",
+				pEvent->Ts, pEvent->Opcode == 3 ? "Private" : "Group", pEvent->Type == EVENT_TERM_LC ? "ended " : "",
+				pLc->Source, pLc->Target);
+		}
+		return true;
+
+	case EVENT_TALKER_ALIAS:
+		sprintf_s(pText, TextLength, "TS%u TA(%u): %.*s", pEvent->Ts, pEvent->Alias.Format, (int)pEvent->Alias.Length, pEvent->Alias.pText);
+		return true;
+
+	case EVENT_CALL:
+		FormatCall(pEvent, pText, TextLength);
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+typedef struct Json_t {
+	char *pText;
+	size_t Length;
+	size_t Size;
+} Json_t;
+
+static void JsonAppend(Json_t *pJson, const char *pFormat, ...)
+{
+	va_list Args;
+	int Length;
+
+	if (pJson->Length >= pJson->Size) {
+		return;
+	}
+
+	va_start(Args, pFormat);
+	Length = vsnprintf(pJson->pText + pJson->Length, pJson->Size - pJson->Length, pFormat, Args);
+	va_end(Args);
+
+	if (Length > 0) {
+		pJson->Length += (size_t)Length;
+	}
+}
+
+// Bytes above 0x7F are Latin-1 unless the text is UTF-8, where sequences
+// that do not decode become U+FFFD so the line stays valid JSON
+static void JsonString(Json_t *pJson, const char *pName, const char *pValue, size_t Length, bool bUtf8)
+{
+	size_t i;
+
+	JsonAppend(pJson, ",\"%s\":\"", pName);
+	for (i = 0; i < Length; i++) {
+		const uint8_t Char = (uint8_t)pValue[i];
+
+		if (Char == '"' || Char == '\\') {
+			JsonAppend(pJson, "\\%c", Char);
+		} else if (Char < 0x20 || Char == 0x7F || (Char > 0x7F && !bUtf8)) {
+			JsonAppend(pJson, "\\u%04x", Char);
+		} else if (Char > 0x7F) {
+			const size_t Count = UTF8_GetLength(pValue + i, Length - i);
+
+			if (Count) {
+				JsonAppend(pJson, "%.*s", (int)Count, pValue + i);
+				i += Count - 1;
+			} else {
+				JsonAppend(pJson, "\\ufffd");
+			}
+		} else {
+			JsonAppend(pJson, "%c", Char);
+		}
+	}
+	JsonAppend(pJson, "\"");
+}
+
+static void JsonHex(Json_t *pJson, const uint8_t *pData, size_t Length)
+{
+	JsonAppend(pJson, ",\"data\":\"");
+	if (pJson->Length < pJson->Size) {
+		pJson->Length += HEX_Encode(pJson->pText + pJson->Length, pJson->Size - pJson->Length, pData, Length, false);
+	}
+	JsonAppend(pJson, "\"");
+}
+
+static void JsonBool(Json_t *pJson, const char *pName, bool bValue)
+{
+	JsonAppend(pJson, ",\"%s\":%s", pName, bValue ? "true" : "false");
+}
+
+static void JsonFields(Json_t *pJson, const Event_t *pEvent)
+{
+	switch (pEvent->Type) {
+	case EVENT_CACH:
+		JsonBool(pJson, "bs_sync", pEvent->Cach.bBsSync);
+		JsonBool(pJson, "slot_verified", pEvent->Cach.bSlotVerified);
+		JsonBool(pJson, "slot_changed", pEvent->Cach.bSlotChanged);
+		JsonBool(pJson, "busy", pEvent->Cach.bBusy);
+		JsonAppend(pJson, ",\"outbound_ts\":%u,\"kind\":%u", pEvent->Cach.Ts, pEvent->Cach.Kind);
+		break;
+
+	case EVENT_BURST:
+		JsonString(pJson, "name", kDataTypes[pEvent->DataType & 15], strlen(kDataTypes[pEvent->DataType & 15]), false);
+		JsonHex(pJson, pEvent->pData, pEvent->Length);
+		break;
+
+	case EVENT_CSBK:
+	case EVENT_COMMAND:
+		JsonHex(pJson, pEvent->pData, pEvent->Length);
+		break;
+
+	case EVENT_ALOHA:
+		JsonAppend(pJson, ",\"ms_address\":%u,\"code\":%u,\"version\":%u,\"mask\":%u,\"service\":%u,\"nrand\":%u,\"backoff\":%u",
+			pEvent->Aloha.MsAddress, pEvent->Aloha.Code, pEvent->Aloha.Version, pEvent->Aloha.Mask,
+			pEvent->Aloha.Service, pEvent->Aloha.NRand, pEvent->Aloha.Backoff);
+		JsonBool(pJson, "tsccas", pEvent->Aloha.bTsccas);
+		JsonBool(pJson, "sync", pEvent->Aloha.bSync);
+		JsonBool(pJson, "offset", pEvent->Aloha.bOffset);
+		JsonBool(pJson, "active", pEvent->Aloha.bActive);
+		JsonBool(pJson, "reg", pEvent->Aloha.bReg);
+		break;
+
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+		JsonAppend(pJson, ",\"source\":%u,\"target\":%u,\"channel\":%u,\"slot\":%u",
+			pEvent->Grant.Source, pEvent->Grant.Target, pEvent->Grant.Channel, pEvent->Grant.Slot);
+		JsonBool(pJson, "emergency", pEvent->Grant.bEmergency);
+		JsonBool(pJson, "late_entry", pEvent->Grant.bLateEntry);
+		JsonBool(pJson, "offset", pEvent->Grant.bOffset);
+		break;
+
+	case EVENT_AHOY:
+		JsonAppend(pJson, ",\"source\":%u,\"target\":%u,\"service\":%u,\"kind\":%u,\"blocks\":%u",
+			pEvent->Ahoy.Source, pEvent->Ahoy.Target, pEvent->Ahoy.Service, pEvent->Ahoy.Kind, pEvent->Ahoy.Blocks);
+		JsonBool(pJson, "flag", pEvent->Ahoy.bFlag);
+		JsonBool(pJson, "ambient", pEvent->Ahoy.bAmbient);
+		JsonBool(pJson, "group", pEvent->Ahoy.bGroup);
+		break;
+
+	case EVENT_C_ACKD:
+		JsonAppend(pJson, ",\"source\":%u,\"target\":%u,\"response\":%u,\"reason\":%u",
+			pEvent->Ackd.Source, pEvent->Ackd.Target, pEvent->Ackd.Response, pEvent->Ackd.Reason);
+		break;
+
+	case EVENT_C_BCAST:
+		JsonAppend(pJson, ",\"kind\":%u,\"code\":%u,\"params1\":%u,\"params2\":%u,\"backoff\":%u",
+			pEvent->Bcast.Kind, pEvent->Bcast.Code, pEvent->Bcast.Params1, pEvent->Bcast.Params2, pEvent->Bcast.Backoff);
+		JsonBool(pJson, "reg", pEvent->Bcast.bReg);
+		break;
+
+	case EVENT_P_PROTECT:
+		JsonAppend(pJson, ",\"source\":%u,\"target\":%u,\"kind\":%u",
+			pEvent->Protect.Source, pEvent->Protect.Target, pEvent->Protect.Kind);
+		JsonBool(pJson, "group", pEvent->Protect.bGroup);
+		break;
+
+	case EVENT_VOICE_LC:
+	case EVENT_TERM_LC:
+		JsonAppend(pJson, ",\"fid\":%u", pEvent->Lc.Fid);
+		if (pEvent->pData) {
+			JsonHex(pJson, pEvent->pData, pEvent->Length);
+		} else {
+			JsonAppend(pJson, ",\"source\":%u,\"target\":%u,\"options\":%u", pEvent->Lc.Source, pEvent->Lc.Target, pEvent->Lc.Options);
+		}
+		break;
+
+	case EVENT_TALKER_ALIAS:
+		JsonAppend(pJson, ",\"format\":%u", pEvent->Alias.Format);
+		// UTF-16 aliases were converted by the decoder
+		JsonString(pJson, "alias", pEvent->Alias.pText, pEvent->Alias.Length, pEvent->Alias.Format >= 2);
+		break;
+
+	case EVENT_CALL:
+		JsonAppend(pJson, ",\"end\":%llu,\"duration_ms\":%llu,\"source\":%u,\"target\":%u",
+			(unsigned long long)pEvent->Call.End, (unsigned long long)((pEvent->Call.End - pEvent->Call.Start) / 1000000U),
+			pEvent->Call.Source, pEvent->Call.Target);
+		JsonBool(pJson, "private", pEvent->Call.bPrivate);
+		JsonBool(pJson, "emergency", pEvent->Call.bEmergency);
+		JsonBool(pJson, "late_entry", pEvent->Call.bLateEntry);
+		JsonBool(pJson, "ended", pEvent->Call.bEnded);
+		if (pEvent->Call.Channel) {
+			JsonAppend(pJson, ",\"channel\":%u,\"slot\":%u", pEvent->Call.Channel, pEvent->Call.Slot);
+		}
+		if (pEvent->Call.pAlias) {
+			JsonAppend(pJson, ",\"alias_format\":%u", pEvent->Call.AliasFormat);
+			JsonString(pJson, "alias", pEvent->Call.pAlias, pEvent->Call.AliasLength, pEvent->Call.AliasFormat >= 2);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+static uint8_t Pack(bool b0, bool b1, bool b2, bool b3, bool b4)
+{
+	return (uint8_t)(b0 | (b1 << 1) | (b2 << 2) | (b3 << 3) | (b4 << 4));
+}
+
+static size_t PutRaw(uint8_t *pBody, size_t Free, const uint8_t *pData, size_t Length)
+{
+	if (Length > Free) {
+		Length = Free;
+	}
+	if (Length) {
+		memcpy(pBody, pData, Length);
+	}
+
+	return Length;
+}
+
+// Fixed fields of each event type, followed by its raw bytes if any
+static size_t PutFields(const Event_t *pEvent, uint8_t *pBody, size_t Free)
+{
+	// Every body but the raw ones starts with up to 12 fixed bytes
+	if (Free < 12) {
+		return 0;
+	}
+
+	switch (pEvent->Type) {
+	case EVENT_CACH:
+		pBody[0] = Pack(pEvent->Cach.bBsSync, pEvent->Cach.bSlotVerified, pEvent->Cach.bSlotChanged, pEvent->Cach.bBusy, false);
+		pBody[1] = pEvent->Cach.Ts;
+		pBody[2] = pEvent->Cach.Kind;
+		return 3;
+
+	case EVENT_BURST:
+		return PutRaw(pBody, Free, pEvent->pData, pEvent->Length);
+
+	case EVENT_CSBK:
+	case EVENT_COMMAND:
+		pBody[0] = pEvent->Opcode;
+		return 1 + PutRaw(pBody + 1, Free - 1, pEvent->pData, pEvent->Length);
+
+	case EVENT_ALOHA:
+		PutU32(pBody, pEvent->Aloha.MsAddress);
+		PutU16(pBody + 4, pEvent->Aloha.Code);
+		pBody[6] = pEvent->Aloha.Version;
+		pBody[7] = pEvent->Aloha.Mask;
+		pBody[8] = pEvent->Aloha.Service;
+		pBody[9] = pEvent->Aloha.NRand;
+		pBody[10] = pEvent->Aloha.Backoff;
+		pBody[11] = Pack(pEvent->Aloha.bTsccas, pEvent->Aloha.bSync, pEvent->Aloha.bOffset, pEvent->Aloha.bActive, pEvent->Aloha.bReg);
+		return 12;
+
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+		PutU32(pBody, pEvent->Grant.Source);
+		PutU32(pBody + 4, pEvent->Grant.Target);
+		PutU16(pBody + 8, pEvent->Grant.Channel);
+		pBody[10] = pEvent->Grant.Slot;
+		pBody[11] = Pack(pEvent->Grant.bEmergency, pEvent->Grant.bLateEntry, pEvent->Grant.bOffset, false, false);
+		return 12;
+
+	case EVENT_AHOY:
+		PutU32(pBody, pEvent->Ahoy.Source);
+		PutU32(pBody + 4, pEvent->Ahoy.Target);
+		pBody[8] = pEvent->Ahoy.Service;
+		pBody[9] = pEvent->Ahoy.Kind;
+		pBody[10] = pEvent->Ahoy.Blocks;
+		pBody[11] = Pack(pEvent->Ahoy.bFlag, pEvent->Ahoy.bAmbient, pEvent->Ahoy.bGroup, false, false);
+		return 12;
+
+	case EVENT_C_ACKD:
+		PutU32(pBody, pEvent->Ackd.Source);
+		PutU32(pBody + 4, pEvent->Ackd.Target);
+		pBody[8] = pEvent->Ackd.Response;
+		pBody[9] = pEvent->Ackd.Reason;
+		return 10;
+
+	case EVENT_C_BCAST:
+		PutU32(pBody, pEvent->Bcast.Params2);
+		PutU16(pBody + 4, pEvent->Bcast.Code);
+		PutU16(pBody + 6, pEvent->Bcast.Params1);
+		pBody[8] = pEvent->Bcast.Kind;
+		pBody[9] = pEvent->Bcast.Backoff;
+		pBody[10] = Pack(pEvent->Bcast.bReg, false, false, false, false);
+		return 11;
+
+	case EVENT_P_PROTECT:
+		PutU32(pBody, pEvent->Protect.Source);
+		PutU32(pBody + 4, pEvent->Protect.Target);
+		pBody[8] = pEvent->Protect.Kind;
+		pBody[9] = Pack(pEvent->Protect.bGroup, false, false, false, false);
+		return 10;
+
+	case EVENT_VOICE_LC:
+	case EVENT_TERM_LC:
+		PutU32(pBody, pEvent->Lc.Source);
+		PutU32(pBody + 4, pEvent->Lc.Target);
+		pBody[8] = pEvent->Opcode;
+		pBody[9] = pEvent->Lc.Fid;
+		pBody[10] = pEvent->Lc.Options;
+		return 11 + PutRaw(pBody + 11, Free - 11, pEvent->pData, pEvent->Length);
+
+	case EVENT_TALKER_ALIAS:
+		pBody[0] = pEvent->Alias.Format;
+		return 1 + PutRaw(pBody + 1, Free - 1, (const uint8_t *)pEvent->Alias.pText, pEvent->Alias.Length);
+
+	case EVENT_CALL:
+		if (Free < 21) {
+			return 0;
+		}
+		PutU64(pBody, pEvent->Call.End);
+		PutU32(pBody + 8, pEvent->Call.Source);
+		PutU32(pBody + 12, pEvent->Call.Target);
+		PutU16(pBody + 16, pEvent->Call.Channel);
+		pBody[18] = pEvent->Call.Slot;
+		pBody[19] = Pack(pEvent->Call.bPrivate, pEvent->Call.bEmergency, pEvent->Call.bLateEntry, pEvent->Call.bEnded, false);
+		pBody[20] = pEvent->Call.AliasFormat;
+		return 21 + PutRaw(pBody + 21, Free - 21, (const uint8_t *)pEvent->Call.pAlias, pEvent->Call.pAlias ? pEvent->Call.AliasLength : 0);
+
+	default:
+		return 0;
+	}
+}
+
+// Repeat summaries end with their count
+static size_t AppendRepeats(const Event_t *pEvent, char *pStart, size_t TextLength)
+{
+	char Count[32];
+
+	if (pEvent->Flags & EVENT_REPEATED) {
+		sprintf_s(Count, sizeof(Count), " (repeated x%u)", pEvent->Repeats);
+		strcat_s(pStart, TextLength, Count);
+	}
+
+	return strlen(pStart);
+}
+
+// Public
+
+size_t EVENT_FormatText(const Event_t *pEvent, char *pText, size_t TextLength)
+{
+	const size_t Size = TextLength;
+	char *pStart = pText;
+	int Skip;
+
+	if (!TextLength) {
+		return 0;
+	}
+	pText[0] = 0;
+
+	if (pEvent->Type == EVENT_CACH) {
+		FormatCach(&pEvent->Cach, pText, TextLength);
+		return AppendRepeats(pEvent, pStart, Size);
+	}
+	if (pEvent->Type == EVENT_COMMAND) {
+		sprintf_s(pText, TextLength, "Frame %02X", pEvent->Opcode);
+		HEX_Append(pText, TextLength, "", pEvent->pData, pEvent->Length);
+		return AppendRepeats(pEvent, pStart, Size);
+	}
+
+	Skip = sprintf_s(pText, TextLength, "TS%u-C%02u: ", pEvent->Ts, pEvent->Cc);
+	if (Skip < 0 || (size_t)Skip >= TextLength) {
+		return 0;
+	}
+	pText += Skip;
+	TextLength -= Skip;
+
+	if (HasBurstLabel(pEvent)) {
+		strcat_s(pText, TextLength, (pEvent->Flags & EVENT_VOICE) ? "Voice Burst: " : "Data Burst: ");
+	}
+
+	if (!FormatBurst(pEvent, pText, TextLength)) {
+		pStart[0] = 0;
+		return 0;
+	}
+
+	return AppendRepeats(pEvent, pStart, Size);
+}
+
+size_t EVENT_FormatJson(const Event_t *pEvent, const EventSource_t *pSource, char *pText, size_t TextLength)
+{
+	Json_t Json;
+
+	Json.pText = pText;
+	Json.Length = 0;
+	Json.Size = TextLength;
+
+	JsonAppend(&Json, "{\"type\":\"%s\"", GetName(pEvent->Type));
+	if (pSource->Realtime) {
+		JsonAppend(&Json, ",\"time\":%llu", (unsigned long long)pSource->Realtime);
+	}
+	if (pSource->pPort) {
+		JsonString(&Json, "port", pSource->pPort, strlen(pSource->pPort), false);
+	}
+	if (pEvent->Type == EVENT_COMMAND) {
+		JsonAppend(&Json, ",\"opcode\":%u", pEvent->Opcode);
+	} else if (pEvent->Type != EVENT_CACH) {
+		JsonAppend(&Json, ",\"ts\":%u,\"cc\":%u,\"data_type\":%u,\"opcode\":%u", pEvent->Ts, pEvent->Cc, pEvent->DataType, pEvent->Opcode);
+		JsonBool(&Json, "voice", (pEvent->Flags & EVENT_VOICE) != 0);
+	}
+	if (pEvent->Flags & EVENT_INCOMPLETE) {
+		JsonBool(&Json, "incomplete", true);
+	} else {
+		JsonFields(&Json, pEvent);
+	}
+	if (pEvent->Flags & EVENT_REPEATED) {
+		JsonAppend(&Json, ",\"repeats\":%u", pEvent->Repeats);
+	}
+	JsonAppend(&Json, "}\n");
+
+	// A truncated record is no longer valid JSON
+	if (Json.Length >= Json.Size) {
+		return 0;
+	}
+
+	return Json.Length;
+}
+
+size_t EVENT_FormatBinary(const Event_t *pEvent, const EventSource_t *pSource, uint8_t *pRecord, size_t RecordLength)
+{
+	size_t Length = EVENT_BINARY_HEADER;
+
+	if (RecordLength < EVENT_BINARY_HEADER) {
+		return 0;
+	}
+
+	if (!(pEvent->Flags & EVENT_INCOMPLETE)) {
+		Length += PutFields(pEvent, pRecord + EVENT_BINARY_HEADER, RecordLength - EVENT_BINARY_HEADER);
+	}
+	if ((pEvent->Flags & EVENT_REPEATED) && RecordLength - Length >= 4) {
+		PutU32(pRecord + Length, pEvent->Repeats);
+		Length += 4;
+	}
+
+	PutU16(pRecord, (uint16_t)Length);
+	pRecord[2] = (uint8_t)pEvent->Type;
+	pRecord[3] = pEvent->Flags;
+	pRecord[4] = pSource->Port;
+	pRecord[5] = pEvent->Ts;
+	pRecord[6] = pEvent->Cc;
+	pRecord[7] = pEvent->DataType;
+	PutU64(pRecord + 8, pSource->Realtime);
+
+	return Length;
+}
@@ -0,0 +1,228 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One decoded DMR event. The decoders only fill these in, the text, JSON Lines
+// and binary renderings are all produced from them.
+//
+// Binary records, all integers little endian:
+//
+//   Header     u16 RecordLength, u8 Type, u8 Flags, u8 Port, u8 Ts, u8 Cc,
+//              u8 DataType, u64 RealtimeNs
+//   CACH       u8 Bits (BsSync, SlotVerified, SlotChanged, Busy), u8 Ts, u8 Kind
+//   Grants     u32 Source, u32 Target, u16 Channel, u8 Slot,
+//              u8 Bits (Emergency, LateEntry, Offset)
+//   ALOHA      u32 MsAddress, u16 Code, u8 Version, u8 Mask, u8 Service,
+//              u8 NRand, u8 Backoff, u8 Bits (Tsccas, Sync, Offset, Active, Reg)
+//   AHOY       u32 Source, u32 Target, u8 Service, u8 Kind, u8 Blocks,
+//              u8 Bits (Flag, Ambient, Group)
+//   C_ACKD     u32 Source, u32 Target, u8 Response, u8 Reason
+//   C_BCAST    u32 Params2, u16 Code, u16 Params1, u8 Kind, u8 Backoff, u8 Bits (Reg)
+//   P_PROTECT  u32 Source, u32 Target, u8 Kind, u8 Bits (Group)
+//   LC         u32 Source, u32 Target, u8 Opcode, u8 Fid, u8 Options, raw bytes
+//   Alias      u8 Format, alias bytes, UTF-8 for UTF-16 aliases (format 3)
+//   Call       u64 EndNs, u32 Source, u32 Target, u16 Channel, u8 Slot,
+//              u8 Bits (Private, Emergency, LateEntry, Ended), u8 AliasFormat,
+//              alias bytes. RealtimeNs is when the call started.
+//   Raw        u8 Opcode (CSBK and command id only), raw bytes
+//
+// Bits are numbered from bit 0 in the order listed. Incomplete events only
+// carry the header. Repeat summaries (EVENT_REPEATED) end with u32 Repeats.
+
+typedef enum EventType_t {
+	EVENT_NONE,
+	EVENT_CACH,
+	EVENT_BURST,        // Burst type the decoders do not parse, kept raw
+	EVENT_CSBK,         // CSBK with an unknown opcode, kept raw
+	EVENT_ALOHA,
+	EVENT_PV_GRANT,
+	EVENT_TV_GRANT,
+	EVENT_BTV_GRANT,
+	EVENT_AHOY,
+	EVENT_C_ACKD,
+	EVENT_C_BCAST,
+	EVENT_P_PROTECT,
+	EVENT_VOICE_LC,     // Raw unless the opcode is a group or private call
+	EVENT_TERM_LC,
+	EVENT_TALKER_ALIAS,
+	EVENT_COMMAND,      // Any other MCU and DMR chip record, see DECODER_SetRaw()
+	EVENT_CALL,         // A whole call, see Calls.h
+} EventType_t;
+
+enum {
+	EVENT_INCOMPLETE = 1 << 0, // The frame ended before the fields did
+	EVENT_VOICE = 1 << 1,      // Carried in a voice burst rather than a data burst
+	EVENT_REPEATED = 1 << 2,   // Summary of the copies folded by Dedup.h
+
+	EVENT_MAX_ALIAS = 64,
+	EVENT_BINARY_HEADER = 16,
+};
+
+typedef enum EventFormat_t {
+	EVENT_TEXT,
+	EVENT_JSON,
+	EVENT_BINARY,
+} EventFormat_t;
+
+typedef struct EventCach_t {
+	bool bBsSync;
+	bool bSlotVerified;
+	bool bSlotChanged;
+	bool bBusy;
+	uint8_t Ts;
+	uint8_t Kind;
+} EventCach_t;
+
+typedef struct EventGrant_t {
+	uint32_t Source;
+	uint32_t Target;
+	uint16_t Channel;
+	uint8_t Slot;
+	bool bEmergency;
+	bool bLateEntry;
+	bool bOffset;
+} EventGrant_t;
+
+typedef struct EventAloha_t {
+	uint32_t MsAddress;
+	uint16_t Code;
+	uint8_t Version;
+	uint8_t Mask;
+	uint8_t Service;
+	uint8_t NRand;
+	uint8_t Backoff;
+	bool bTsccas;
+	bool bSync;
+	bool bOffset;
+	bool bActive;
+	bool bReg;
+} EventAloha_t;
+
+typedef struct EventAhoy_t {
+	uint32_t Source;
+	uint32_t Target;
+	uint8_t Service;
+	uint8_t Kind;
+	uint8_t Blocks;
+	bool bFlag;
+	bool bAmbient;
+	bool bGroup;
+} EventAhoy_t;
+
+typedef struct EventAckd_t {
+	uint32_t Source;
+	uint32_t Target;
+	uint8_t Response;
+	uint8_t Reason;
+} EventAckd_t;
+
+typedef struct EventBcast_t {
+	uint32_t Params2;
+	uint16_t Code;
+	uint16_t Params1;
+	uint8_t Kind;
+	uint8_t Backoff;
+	bool bReg;
+} EventBcast_t;
+
+typedef struct EventProtect_t {
+	uint32_t Source;
+	uint32_t Target;
+	uint8_t Kind;
+	bool bGroup;
+} EventProtect_t;
+
+typedef struct EventLc_t {
+	uint32_t Source;
+	uint32_t Target;
+	uint8_t Fid;
+	uint8_t Options;
+} EventLc_t;
+
+// Borrowed from the decoder, valid until its next call. UTF-8 aliases (format
+// 2) are kept as sent, which may not be valid UTF-8, and UTF-16 aliases
+// (format 3) are converted to UTF-8.
+typedef struct EventAlias_t {
+	uint8_t Format;
+	const char *pText;
+	size_t Length;
+} EventAlias_t;
+
+// Times are realtime in ns, 0 when unknown. Channel and Slot come from the
+// grant, if one was heard.
+typedef struct EventCall_t {
+	uint64_t Start;
+	uint64_t End;
+	uint32_t Source;
+	uint32_t Target;
+	uint16_t Channel;
+	uint8_t Slot;
+	uint8_t AliasFormat;
+	bool bPrivate;
+	bool bEmergency;
+	bool bLateEntry;
+	bool bEnded;        // Closed by its terminator rather than by silence
+	const char *pAlias; // Borrowed from the tracker, NULL without an alias
+	size_t AliasLength;
+} EventCall_t;
+
+typedef struct Event_t {
+	EventType_t Type;
+	uint8_t Flags;
+	uint8_t Ts;
+	uint8_t Cc;
+	uint8_t DataType;
+	uint8_t Opcode;     // CSBK or LC opcode, command id
+	// Raw events view the frame in place, see DECODER_GetFrame()
+	const uint8_t *pData;
+	size_t Length;
+	// Copies heard after this one, in a repeat summary
+	uint32_t Repeats;
+	union {
+		EventCach_t Cach;
+		EventGrant_t Grant;
+		EventAloha_t Aloha;
+		EventAhoy_t Ahoy;
+		EventAckd_t Ackd;
+		EventBcast_t Bcast;
+		EventProtect_t Protect;
+		EventLc_t Lc;
+		EventAlias_t Alias;
+		EventCall_t Call;
+	};
+} Event_t;
+
+// Where an event came from, Realtime 0 and a NULL port name are left out of
+// the text and JSON renderings
+typedef struct EventSource_t {
+	uint64_t Realtime;
+	uint8_t Port;
+	const char *pPort;
+} EventSource_t;
+
+// Each returns the length of the rendering, or 0 if there is nothing to show.
+// The text rendering is the bare sentence, without time or port.
+size_t EVENT_FormatText(const Event_t *pEvent, char *pText, size_t TextLength);
+size_t EVENT_FormatJson(const Event_t *pEvent, const EventSource_t *pSource, char *pText, size_t TextLength);
+size_t EVENT_FormatBinary(const Event_t *pEvent, const EventSource_t *pSource, uint8_t *pRecord, size_t RecordLength);
+
+#endif
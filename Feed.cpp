@@ -0,0 +1,486 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include "Feed.h"
+#include "Platform.h"
+
+enum {
+	FEED_VERSION = 1,
+	FEED_HEADER_SIZE = 4096,
+	FEED_RECORD_SIZE = 24,
+	FEED_NAME_LENGTH = 128,
+};
+
+static const char kFeedMagic[4] = { 'A', 'T', '3', 'F' };
+
+typedef struct FeedHeader_t {
+	char Magic[4];
+	uint16_t Version;
+	uint16_t HeaderSize;
+	uint32_t Format;
+	uint64_t Size;
+	// Next record number, only used by the writer
+	uint64_t Sequence;
+	alignas(64) std::atomic<uint64_t> Head;
+	alignas(64) std::atomic<uint64_t> Tail;
+} FeedHeader_t;
+
+typedef struct FeedEntry_t {
+	uint32_t Length;
+	uint8_t Type;
+	uint8_t Port;
+	uint16_t Reserved;
+	uint64_t Sequence;
+	uint64_t Realtime;
+} FeedEntry_t;
+
+static_assert(sizeof(FeedHeader_t) <= FEED_HEADER_SIZE, "Feed header");
+static_assert(sizeof(FeedEntry_t) == FEED_RECORD_SIZE, "Feed record header");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Feed positions are shared between processes");
+
+typedef struct FeedMap_t {
+#ifdef _WIN32
+	HANDLE hMapping;
+#endif
+	uint8_t *pView;
+	size_t Length;
+} FeedMap_t;
+
+struct Feed_t {
+	FeedMap_t Map;
+	FeedHeader_t *pHeader;
+	uint8_t *pRecords;
+	// Private copies of the shared positions
+	uint64_t Head;
+	uint64_t Tail;
+};
+
+struct FeedReader_t {
+	FeedMap_t Map;
+	const FeedHeader_t *pHeader;
+	const uint8_t *pRecords;
+	uint64_t Size;
+	uint64_t Position;
+	uint64_t Sequence;
+	bool bStarted;
+	FeedReaderStats_t Stats;
+	uint8_t Buffer[FEED_MAX_RECORD];
+};
+
+// Private
+
+#ifdef _WIN32
+
+static void GetObjectName(const char *pName, char *pObject, size_t Length)
+{
+	sprintf_s(pObject, Length, "Local\\AnyTi3r.%s", pName);
+}
+
+static bool CreateMap(FeedMap_t *pMap, const char *pName, size_t Length)
+{
+	char Object[FEED_NAME_LENGTH];
+
+	GetObjectName(pName, Object, sizeof(Object));
+	pMap->hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)Length >> 32), (DWORD)Length, Object);
+	if (!pMap->hMapping) {
+		return false;
+	}
+
+	pMap->pView = (uint8_t *)MapViewOfFile(pMap->hMapping, FILE_MAP_WRITE, 0, 0, Length);
+	if (!pMap->pView) {
+		CloseHandle(pMap->hMapping);
+		return false;
+	}
+	pMap->Length = Length;
+
+	return true;
+}
+
+static bool OpenMap(FeedMap_t *pMap, const char *pName)
+{
+	char Object[FEED_NAME_LENGTH];
+	MEMORY_BASIC_INFORMATION Info;
+
+	GetObjectName(pName, Object, sizeof(Object));
+	pMap->hMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, Object);
+	if (!pMap->hMapping) {
+		return false;
+	}
+
+	pMap->pView = (uint8_t *)MapViewOfFile(pMap->hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!pMap->pView || !VirtualQuery(pMap->pView, &Info, sizeof(Info))) {
+		if (pMap->pView) {
+			UnmapViewOfFile(pMap->pView);
+		}
+		CloseHandle(pMap->hMapping);
+		return false;
+	}
+	pMap->Length = Info.RegionSize;
+
+	return true;
+}
+
+static void CloseMap(FeedMap_t *pMap)
+{
+	UnmapViewOfFile(pMap->pView);
+	CloseHandle(pMap->hMapping);
+}
+
+#else
+
+static void GetObjectName(const char *pName, char *pObject, size_t Length)
+{
+	snprintf(pObject, Length, "/AnyTi3r.%s", pName);
+}
+
+static bool CreateMap(FeedMap_t *pMap, const char *pName, size_t Length)
+{
+	char Object[FEED_NAME_LENGTH];
+	struct stat Stat;
+	void *pView;
+	int Fd;
+
+	GetObjectName(pName, Object, sizeof(Object));
+	Fd = shm_open(Object, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (Fd < 0) {
+		return false;
+	}
+
+	// An object left behind is only grown, readers may still map it
+	if (fstat(Fd, &Stat) < 0 || ((uint64_t)Stat.st_size < Length && ftruncate(Fd, (off_t)Length) < 0)) {
+		close(Fd);
+		return false;
+	}
+
+	pView = mmap(NULL, Length, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+	close(Fd);
+	if (pView == MAP_FAILED) {
+		return false;
+	}
+	pMap->pView = (uint8_t *)pView;
+	pMap->Length = Length;
+
+	return true;
+}
+
+static bool OpenMap(FeedMap_t *pMap, const char *pName)
+{
+	char Object[FEED_NAME_LENGTH];
+	struct stat Stat;
+	void *pView;
+	int Fd;
+
+	GetObjectName(pName, Object, sizeof(Object));
+	Fd = shm_open(Object, O_RDONLY | O_CLOEXEC, 0);
+	if (Fd < 0) {
+		return false;
+	}
+
+	if (fstat(Fd, &Stat) < 0 || !Stat.st_size) {
+		close(Fd);
+		return false;
+	}
+
+	pView = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_SHARED, Fd, 0);
+	close(Fd);
+	if (pView == MAP_FAILED) {
+		return false;
+	}
+	pMap->pView = (uint8_t *)pView;
+	pMap->Length = (size_t)Stat.st_size;
+
+	return true;
+}
+
+static void CloseMap(FeedMap_t *pMap)
+{
+	munmap(pMap->pView, pMap->Length);
+}
+
+#endif
+
+static uint64_t Align(uint64_t Length)
+{
+	return (Length + 7) & ~7ULL;
+}
+
+static bool IsFeed(const FeedHeader_t *pHeader, size_t Length)
+{
+	return !memcmp(pHeader->Magic, kFeedMagic, sizeof(kFeedMagic))
+		&& pHeader->Version == FEED_VERSION
+		&& pHeader->HeaderSize == FEED_HEADER_SIZE
+		&& pHeader->Size >= 2 * FEED_MAX_RECORD
+		&& !(pHeader->Size & (pHeader->Size - 1))
+		&& pHeader->Size <= Length - FEED_HEADER_SIZE;
+}
+
+// Bytes taken by the record at Position, including the skip at the end
+static uint64_t GetSpan(const Feed_t *pFeed, uint64_t Position)
+{
+	const uint64_t Size = pFeed->pHeader->Size;
+	const uint64_t Offset = Position & (Size - 1);
+	FeedEntry_t Entry;
+
+	if (Offset + FEED_RECORD_SIZE > Size) {
+		return Size - Offset;
+	}
+	memcpy(&Entry, pFeed->pRecords + Offset, sizeof(Entry));
+
+	return Align(FEED_RECORD_SIZE + Entry.Length);
+}
+
+// Moves Tail so that End - Tail fits, before any of it is overwritten
+static void MakeRoom(Feed_t *pFeed, uint64_t End)
+{
+	const uint64_t Size = pFeed->pHeader->Size;
+
+	if (End - pFeed->Tail <= Size) {
+		return;
+	}
+	while (End - pFeed->Tail > Size) {
+		pFeed->Tail += GetSpan(pFeed, pFeed->Tail);
+	}
+
+	pFeed->pHeader->Tail.store(pFeed->Tail, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+// Public
+
+Feed_t *FEED_Create(const char *pName, uint32_t Format)
+{
+	Feed_t *pFeed = (Feed_t *)calloc(1, sizeof(Feed_t));
+	FeedHeader_t *pHeader;
+
+	if (!pFeed) {
+		return NULL;
+	}
+
+	if (!CreateMap(&pFeed->Map, pName, FEED_HEADER_SIZE + FEED_SIZE)) {
+		free(pFeed);
+		return NULL;
+	}
+	pHeader = (FeedHeader_t *)pFeed->Map.pView;
+
+	if (IsFeed(pHeader, pFeed->Map.Length) && pHeader->Size == FEED_SIZE) {
+		pFeed->Head = pHeader->Head.load(std::memory_order_relaxed);
+		pFeed->Tail = pHeader->Tail.load(std::memory_order_relaxed);
+	} else {
+		// The magic goes last, readers ignore the feed until then
+		memset(pHeader->Magic, 0, sizeof(pHeader->Magic));
+		std::atomic_thread_fence(std::memory_order_release);
+		pHeader->Version = FEED_VERSION;
+		pHeader->HeaderSize = FEED_HEADER_SIZE;
+		pHeader->Size = FEED_SIZE;
+		pHeader->Sequence = 0;
+		pHeader->Head.store(0, std::memory_order_relaxed);
+		pHeader->Tail.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(pHeader->Magic, kFeedMagic, sizeof(kFeedMagic));
+	}
+	pHeader->Format = Format;
+
+	pFeed->pHeader = pHeader;
+	pFeed->pRecords = pFeed->Map.pView + FEED_HEADER_SIZE;
+
+	return pFeed;
+}
+
+// On Linux the shared memory stays behind for the readers and the next
+// capture, Windows keeps it while a reader has it open
+void FEED_Close(Feed_t *pFeed)
+{
+	if (pFeed) {
+		CloseMap(&pFeed->Map);
+		free(pFeed);
+	}
+}
+
+bool FEED_Publish(Feed_t *pFeed, uint8_t Type, uint8_t Port, uint64_t Realtime, const void *pData, size_t Length)
+{
+	FeedHeader_t *pHeader = pFeed->pHeader;
+	const uint64_t Size = pHeader->Size;
+	const uint64_t Need = Align(FEED_RECORD_SIZE + Length);
+	uint64_t Position = pFeed->Head;
+	uint64_t Offset = Position & (Size - 1);
+	FeedEntry_t Entry;
+
+	if (Type >= FEED_PAD || Length > FEED_MAX_RECORD) {
+		return false;
+	}
+
+	memset(&Entry, 0, sizeof(Entry));
+
+	if (Offset + Need > Size) {
+		const uint64_t Skip = Size - Offset;
+
+		MakeRoom(pFeed, Position + Skip + Need);
+		if (Skip >= FEED_RECORD_SIZE) {
+			Entry.Type = FEED_PAD;
+			Entry.Length = (uint32_t)(Skip - FEED_RECORD_SIZE);
+			memcpy(pFeed->pRecords + Offset, &Entry, sizeof(Entry));
+		}
+		Position += Skip;
+		Offset = 0;
+	} else {
+		MakeRoom(pFeed, Position + Need);
+	}
+
+	Entry.Length = (uint32_t)Length;
+	Entry.Type = Type;
+	Entry.Port = Port;
+	Entry.Sequence = pHeader->Sequence++;
+	Entry.Realtime = Realtime;
+	memcpy(pFeed->pRecords + Offset, &Entry, sizeof(Entry));
+	memcpy(pFeed->pRecords + Offset + sizeof(Entry), pData, Length);
+
+	pFeed->Head = Position + Need;
+	pHeader->Head.store(pFeed->Head, std::memory_order_release);
+
+	return true;
+}
+
+FeedReader_t *FEED_Attach(const char *pName)
+{
+	FeedReader_t *pReader = (FeedReader_t *)calloc(1, sizeof(FeedReader_t));
+
+	if (!pReader) {
+		return NULL;
+	}
+
+	if (!OpenMap(&pReader->Map, pName)) {
+		free(pReader);
+		return NULL;
+	}
+
+	// The rest of the header is only read once the magic is there
+	pReader->pHeader = (const FeedHeader_t *)pReader->Map.pView;
+	if (pReader->Map.Length < FEED_HEADER_SIZE || memcmp(pReader->pHeader->Magic, kFeedMagic, sizeof(kFeedMagic))) {
+		CloseMap(&pReader->Map);
+		free(pReader);
+		return NULL;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (!IsFeed(pReader->pHeader, pReader->Map.Length)) {
+		CloseMap(&pReader->Map);
+		free(pReader);
+		return NULL;
+	}
+
+	pReader->pRecords = pReader->Map.pView + FEED_HEADER_SIZE;
+	pReader->Size = pReader->pHeader->Size;
+	pReader->Position = pReader->pHeader->Head.load(std::memory_order_acquire);
+
+	return pReader;
+}
+
+void FEED_Detach(FeedReader_t *pReader)
+{
+	if (pReader) {
+		CloseMap(&pReader->Map);
+		free(pReader);
+	}
+}
+
+uint32_t FEED_GetFormat(const FeedReader_t *pReader)
+{
+	return pReader->pHeader->Format;
+}
+
+bool FEED_Next(FeedReader_t *pReader, FeedRecord_t *pRecord)
+{
+	const FeedHeader_t *pHeader = pReader->pHeader;
+	const uint64_t Size = pReader->Size;
+
+	for (;;) {
+		const uint64_t Head = pHeader->Head.load(std::memory_order_acquire);
+		const uint64_t Position = pReader->Position;
+		const uint64_t Offset = Position & (Size - 1);
+		FeedEntry_t Entry;
+		uint64_t Tail;
+		bool bValid;
+
+		// Ahead of the writer only after it started over on a new feed
+		if (Position >= Head) {
+			pReader->Position = Head;
+			return false;
+		}
+
+		if (Offset + FEED_RECORD_SIZE > Size) {
+			pReader->Position += Size - Offset;
+			continue;
+		}
+
+		memcpy(&Entry, pReader->pRecords + Offset, sizeof(Entry));
+		bValid = Entry.Type <= FEED_PAD && Entry.Length <= FEED_MAX_RECORD && Offset + FEED_RECORD_SIZE + Entry.Length <= Size;
+		if (bValid && Entry.Type != FEED_PAD) {
+			memcpy(pReader->Buffer, pReader->pRecords + Offset + FEED_RECORD_SIZE, Entry.Length);
+		}
+
+		// Whatever was copied only counts if the writer has not moved past it
+		std::atomic_thread_fence(std::memory_order_acquire);
+		Tail = pHeader->Tail.load(std::memory_order_relaxed);
+		if (Position < Tail) {
+			pReader->Position = Tail;
+			pReader->Stats.Laps++;
+			continue;
+		}
+		if (!bValid) {
+			pReader->Position = Head;
+			pReader->Stats.Laps++;
+			continue;
+		}
+
+		pReader->Position = Position + Align(FEED_RECORD_SIZE + Entry.Length);
+		if (Entry.Type == FEED_PAD) {
+			continue;
+		}
+
+		if (pReader->bStarted && Entry.Sequence > pReader->Sequence) {
+			pReader->Stats.Lost += Entry.Sequence - pReader->Sequence;
+		}
+		pReader->Sequence = Entry.Sequence + 1;
+		pReader->bStarted = true;
+		pReader->Stats.Records++;
+
+		pRecord->Sequence = Entry.Sequence;
+		pRecord->Realtime = Entry.Realtime;
+		pRecord->pData = pReader->Buffer;
+		pRecord->Length = Entry.Length;
+		pRecord->Type = Entry.Type;
+		pRecord->Port = Entry.Port;
+
+		return true;
+	}
+}
+
+void FEED_GetReaderStats(const FeedReader_t *pReader, FeedReaderStats_t *pStats)
+{
+	*pStats = pReader->Stats;
+}
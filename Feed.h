@@ -0,0 +1,87 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef FEED_H
+#define FEED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Single writer, many readers ring in named shared memory, so local programs
+// can follow the decoded stream of a running capture.
+//
+//   Header   "AT3F", u16 Version, u16 HeaderSize, u32 Format, u64 Size,
+//            u64 Sequence, then Head and Tail each on their own cache line
+//   Record   u32 Length, u8 Type, u8 Port, u16 Reserved, u64 Sequence,
+//            u64 RealtimeNs, Length bytes, padded to 8 bytes
+//
+// Head and Tail are byte positions that only grow, the record at Position
+// is at Position % Size. Records never straddle the end, a PAD record or less
+// than a record header of room left skips to the start. The writer moves Tail
+// past the records it is about to overwrite before it touches them, and
+// publishes a record by moving Head past it.
+//
+// Readers never write to the shared memory, so they cost the writer nothing.
+// Each keeps its own position, copies a record out and then checks Tail: a
+// position behind Tail was lapped, the copy may be torn and the reader starts
+// again from Tail. Sequence gaps tell how many records a reader lost.
+enum {
+	FEED_LINE = 0,
+	FEED_FRAME = 1,
+	FEED_PAD = 2,
+};
+
+enum {
+	// A power of 2
+	FEED_SIZE = 16 * 1024 * 1024,
+	FEED_MAX_RECORD = 64 * 1024,
+};
+
+typedef struct Feed_t Feed_t;
+typedef struct FeedReader_t FeedReader_t;
+
+// pData stays valid until the next FEED_Next() call
+typedef struct FeedRecord_t {
+	uint64_t Sequence;
+	uint64_t Realtime;
+	const uint8_t *pData;
+	uint32_t Length;
+	uint8_t Type;
+	uint8_t Port;
+} FeedRecord_t;
+
+typedef struct FeedReaderStats_t {
+	uint64_t Records;
+	uint64_t Lost;
+	uint64_t Laps;
+} FeedReaderStats_t;
+
+// Format is the EventFormat_t of the lines. A feed left behind by an earlier
+// capture is taken over as it is, so its readers carry on.
+Feed_t *FEED_Create(const char *pName, uint32_t Format);
+void FEED_Close(Feed_t *pFeed);
+bool FEED_Publish(Feed_t *pFeed, uint8_t Type, uint8_t Port, uint64_t Realtime, const void *pData, size_t Length);
+
+// Readers start at the newest record
+FeedReader_t *FEED_Attach(const char *pName);
+void FEED_Detach(FeedReader_t *pReader);
+uint32_t FEED_GetFormat(const FeedReader_t *pReader);
+// Returns false when the reader has caught up with the writer
+bool FEED_Next(FeedReader_t *pReader, FeedRecord_t *pRecord);
+void FEED_GetReaderStats(const FeedReader_t *pReader, FeedReaderStats_t *pStats);
+
+#endif
@@ -0,0 +1,264 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Filter.h"
+
+typedef enum FilterKey_t {
+	FILTER_CMD,
+	FILTER_TYPE,
+	FILTER_OPCODE,
+	FILTER_FID,
+	FILTER_TS,
+	FILTER_CC,
+	FILTER_ID,
+	FILTER_KEYS,
+} FilterKey_t;
+
+enum {
+	FILTER_TABLE = FILTER_MAX_IDS * 2, // Open addressing, at most half full
+};
+
+static const struct {
+	const char *pName;
+	uint32_t Max;
+} kKeys[FILTER_KEYS] = {
+	{ "cmd", 0xFF },
+	{ "type", 15 },
+	{ "opcode", 63 },
+	{ "fid", 0xFF },
+	{ "ts", 2 },
+	{ "cc", 15 },
+	{ "id", 0xFFFFFF },
+};
+
+// Addresses plus one, 0 marks a free slot
+typedef struct FilterSet_t {
+	size_t Count;
+	uint32_t Table[FILTER_TABLE];
+} FilterSet_t;
+
+struct Filter_t {
+	// One bit per accepted value of each key
+	uint8_t Maps[FILTER_ID][32];
+	// The first allow rule of a key starts from an empty map
+	bool bAllowed[FILTER_ID];
+	FilterSet_t Allow;
+	FilterSet_t Deny;
+};
+
+// Private
+
+static bool IsSet(const uint8_t *pMap, uint32_t Value)
+{
+	return (pMap[Value >> 3] >> (Value & 7)) & 1;
+}
+
+static size_t GetHome(uint32_t Id)
+{
+	return (size_t)((Id * 0x9E3779B1U) >> 16) & (FILTER_TABLE - 1);
+}
+
+static bool Contains(const FilterSet_t *pSet, uint32_t Id)
+{
+	size_t Slot = GetHome(Id);
+
+	if (!pSet->Count) {
+		return false;
+	}
+	while (pSet->Table[Slot]) {
+		if (pSet->Table[Slot] == Id + 1) {
+			return true;
+		}
+		Slot = (Slot + 1) & (FILTER_TABLE - 1);
+	}
+
+	return false;
+}
+
+static bool Insert(FilterSet_t *pSet, uint32_t Id)
+{
+	size_t Slot = GetHome(Id);
+
+	if (Contains(pSet, Id)) {
+		return true;
+	}
+	if (pSet->Count == FILTER_MAX_IDS) {
+		return false;
+	}
+	while (pSet->Table[Slot]) {
+		Slot = (Slot + 1) & (FILTER_TABLE - 1);
+	}
+	pSet->Table[Slot] = Id + 1;
+	pSet->Count++;
+
+	return true;
+}
+
+static bool Apply(Filter_t *pFilter, FilterKey_t Key, bool bDeny, uint32_t Value)
+{
+	if (Key == FILTER_ID) {
+		return Insert(bDeny ? &pFilter->Deny : &pFilter->Allow, Value);
+	}
+
+	if (bDeny) {
+		pFilter->Maps[Key][Value >> 3] &= (uint8_t)~(1U << (Value & 7));
+	} else {
+		if (!pFilter->bAllowed[Key]) {
+			memset(pFilter->Maps[Key], 0, sizeof(pFilter->Maps[Key]));
+			pFilter->bAllowed[Key] = true;
+		}
+		pFilter->Maps[Key][Value >> 3] |= (uint8_t)(1U << (Value & 7));
+	}
+
+	return true;
+}
+
+// Addresses of the event types that carry any
+static bool GetAddresses(const Event_t *pEvent, uint32_t *pSource, uint32_t *pTarget)
+{
+	switch (pEvent->Type) {
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+		*pSource = pEvent->Grant.Source;
+		*pTarget = pEvent->Grant.Target;
+		return true;
+	case EVENT_ALOHA:
+		*pSource = *pTarget = pEvent->Aloha.MsAddress;
+		return true;
+	case EVENT_AHOY:
+		*pSource = pEvent->Ahoy.Source;
+		*pTarget = pEvent->Ahoy.Target;
+		return true;
+	case EVENT_C_ACKD:
+		*pSource = pEvent->Ackd.Source;
+		*pTarget = pEvent->Ackd.Target;
+		return true;
+	case EVENT_P_PROTECT:
+		*pSource = pEvent->Protect.Source;
+		*pTarget = pEvent->Protect.Target;
+		return true;
+	case EVENT_VOICE_LC:
+	case EVENT_TERM_LC:
+		if (pEvent->pData) {
+			return false;
+		}
+		*pSource = pEvent->Lc.Source;
+		*pTarget = pEvent->Lc.Target;
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Public
+
+Filter_t *FILTER_New(void)
+{
+	Filter_t *pFilter;
+
+	pFilter = (Filter_t *)calloc(1, sizeof(Filter_t));
+	if (pFilter) {
+		memset(pFilter->Maps, 0xFF, sizeof(pFilter->Maps));
+	}
+
+	return pFilter;
+}
+
+void FILTER_Free(Filter_t *pFilter)
+{
+	free(pFilter);
+}
+
+bool FILTER_AddRule(Filter_t *pFilter, const char *pRule)
+{
+	const char *pValues;
+	bool bDeny = false;
+	size_t Length;
+	size_t Key;
+
+	if (*pRule == '!') {
+		bDeny = true;
+		pRule++;
+	}
+	pValues = strchr(pRule, '=');
+	if (!pValues) {
+		return false;
+	}
+	Length = (size_t)(pValues - pRule);
+	for (Key = 0; Key < FILTER_KEYS; Key++) {
+		if (strlen(kKeys[Key].pName) == Length && !strncmp(kKeys[Key].pName, pRule, Length)) {
+			break;
+		}
+	}
+	if (Key == FILTER_KEYS) {
+		return false;
+	}
+
+	do {
+		unsigned long Value;
+		char *pEnd;
+
+		pValues++;
+		Value = strtoul(pValues, &pEnd, 0);
+		if (pEnd == pValues || (*pEnd && *pEnd != ',') || Value > kKeys[Key].Max) {
+			return false;
+		}
+		if (!Apply(pFilter, (FilterKey_t)Key, bDeny, (uint32_t)Value)) {
+			return false;
+		}
+		pValues = pEnd;
+	} while (*pValues == ',');
+
+	return true;
+}
+
+bool FILTER_AcceptCommand(const Filter_t *pFilter, uint8_t Id)
+{
+	return IsSet(pFilter->Maps[FILTER_CMD], Id);
+}
+
+bool FILTER_AcceptBurst(const Filter_t *pFilter, uint8_t Ts, uint8_t Cc, uint8_t DataType)
+{
+	return IsSet(pFilter->Maps[FILTER_TS], Ts) && IsSet(pFilter->Maps[FILTER_CC], Cc) && IsSet(pFilter->Maps[FILTER_TYPE], DataType);
+}
+
+bool FILTER_AcceptCsbk(const Filter_t *pFilter, uint8_t Opcode, uint8_t Fid)
+{
+	return IsSet(pFilter->Maps[FILTER_OPCODE], Opcode) && IsSet(pFilter->Maps[FILTER_FID], Fid);
+}
+
+bool FILTER_AcceptFid(const Filter_t *pFilter, uint8_t Fid)
+{
+	return IsSet(pFilter->Maps[FILTER_FID], Fid);
+}
+
+bool FILTER_AcceptEvent(const Filter_t *pFilter, const Event_t *pEvent)
+{
+	uint32_t Source;
+	uint32_t Target;
+
+	if ((!pFilter->Allow.Count && !pFilter->Deny.Count) || !GetAddresses(pEvent, &Source, &Target)) {
+		return true;
+	}
+	if (Contains(&pFilter->Deny, Source) || Contains(&pFilter->Deny, Target)) {
+		return false;
+	}
+
+	return !pFilter->Allow.Count || Contains(&pFilter->Allow, Source) || Contains(&pFilter->Allow, Target);
+}
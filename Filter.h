@@ -0,0 +1,59 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Event.h"
+
+// Decides which records are worth decoding. Each test runs as soon as the
+// decoder has read the bytes it needs, so rejected records skip field
+// extraction and formatting. Everything is accepted until a rule says
+// otherwise.
+//
+// Rules are "key=values" to keep only those values, or "!key=values" to drop
+// them. Values are comma separated, decimal or 0x hex:
+//
+//   cmd     MCU and DMR chip record id
+//   type    Data type of a burst
+//   opcode  CSBK opcode
+//   fid     Feature set id of CSBKs and call LCs
+//   ts      Timeslot of a burst, 1 or 2
+//   cc      Colour code of a burst
+//   id      Source or target address, events without any are kept
+enum {
+	FILTER_MAX_IDS = 1024,
+};
+
+typedef struct Filter_t Filter_t;
+
+Filter_t *FILTER_New(void);
+void FILTER_Free(Filter_t *pFilter);
+// Returns false for a rule that does not parse
+bool FILTER_AddRule(Filter_t *pFilter, const char *pRule);
+
+bool FILTER_AcceptCommand(const Filter_t *pFilter, uint8_t Id);
+bool FILTER_AcceptBurst(const Filter_t *pFilter, uint8_t Ts, uint8_t Cc, uint8_t DataType);
+bool FILTER_AcceptCsbk(const Filter_t *pFilter, uint8_t Opcode, uint8_t Fid);
+bool FILTER_AcceptFid(const Filter_t *pFilter, uint8_t Fid);
+// Checks the addresses once the fields are known
+bool FILTER_AcceptEvent(const Filter_t *pFilter, const Event_t *pEvent);
+
+#endif
@@ -0,0 +1,349 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "BitStream.h"
+#include "Decoder.h"
+#include "Generator.h"
+
+static const struct {
+	const char *pName;
+	uint32_t Weight;
+} kKinds[GENERATOR_KINDS] = {
+	{ "csbk", 40 },
+	{ "voice", 20 },
+	{ "term", 5 },
+	{ "alias", 10 },
+	{ "cach", 15 },
+	{ "cc", 5 },
+	{ "burst", 3 },
+	{ "cmd", 2 },
+};
+
+// The opcodes the decoders parse, then two they dump raw
+static const uint8_t kOpcodes[] = { 0x19, 0x30, 0x31, 0x32, 0x1C, 0x20, 0x28, 0x2F, 0x05, 0x3E };
+static const uint8_t kCommands[] = { 0x01, 0x10, 0x22, 0x50 };
+static const uint8_t kBursts[] = { 0, 6, 7, 8, 9 };
+static const uint8_t kMagic[3] = { 0x84, 0xA9, 0x61 };
+
+// Talker alias being sent on a timeslot, Sent counts the characters so far.
+// Aliases alternate between ISO 8859 and UTF-8 with a two byte character.
+typedef struct GeneratorAlias_t {
+	uint8_t Next;
+	uint8_t Sent;
+	uint8_t Length;
+	bool bUtf8;
+	char Text[32];
+} GeneratorAlias_t;
+
+struct Generator_t {
+	GeneratorMix_t Mix;
+	uint32_t Total;
+	uint32_t State;
+	int Opcode;
+	bool bTs;
+	GeneratorAlias_t Aliases[2];
+};
+
+// Private
+
+static uint32_t Random(Generator_t *pGenerator)
+{
+	uint32_t x = pGenerator->State;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	pGenerator->State = x;
+
+	return x;
+}
+
+// Talkgroups and radios come from small pools, like on a real site
+static uint32_t GetAddress(Generator_t *pGenerator, bool bGroup)
+{
+	if (bGroup) {
+		return 90 + Random(pGenerator) % 8;
+	}
+
+	return 2300000 + Random(pGenerator) % 64;
+}
+
+static GeneratorKind_t GetKind(Generator_t *pGenerator)
+{
+	uint32_t Pick = Random(pGenerator) % pGenerator->Total;
+	size_t i;
+
+	for (i = 0; i < GENERATOR_KINDS - 1; i++) {
+		if (Pick < pGenerator->Mix.Weights[i]) {
+			break;
+		}
+		Pick -= pGenerator->Mix.Weights[i];
+	}
+
+	return (GeneratorKind_t)i;
+}
+
+// Data bursts alternate between the timeslots
+static void PushBurst(Generator_t *pGenerator, BitWriter_t *pBw, uint8_t DataType, bool bVoice)
+{
+	pGenerator->bTs = !pGenerator->bTs;
+	BW_PushU8(pBw, 0x43);
+	BW_PushBits(pBw, pGenerator->bTs, 1);
+	BW_PushBits(pBw, 0, 2);
+	BW_PushBits(pBw, bVoice, 1);
+	BW_PushBits(pBw, DataType, 4);
+}
+
+static void PushCsbk(Generator_t *pGenerator, BitWriter_t *pBw)
+{
+	uint8_t Opcode = (uint8_t)pGenerator->Opcode;
+	bool bGroup;
+
+	if (pGenerator->Opcode < 0) {
+		Opcode = kOpcodes[Random(pGenerator) % sizeof(kOpcodes)];
+	}
+	bGroup = Opcode == 0x31 || Opcode == 0x32;
+
+	PushBurst(pGenerator, pBw, 3, false);
+	BW_PushU8(pBw, 10);
+	BW_PushBits(pBw, 0, 2);
+	BW_PushBits(pBw, Opcode, 6);
+	BW_PushU8(pBw, 0);
+	// Most bodies end with the target and the source
+	BW_PushBits(pBw, Random(pGenerator), 16);
+	BW_PushBits(pBw, GetAddress(pGenerator, bGroup), 24);
+	BW_PushBits(pBw, GetAddress(pGenerator, false), 24);
+}
+
+static void PushCall(Generator_t *pGenerator, BitWriter_t *pBw, uint8_t DataType)
+{
+	const bool bGroup = Random(pGenerator) % 4 != 0;
+
+	PushBurst(pGenerator, pBw, DataType, DataType == 1);
+	BW_PushU8(pBw, 9);
+	BW_PushBits(pBw, 0, 2);
+	BW_PushBits(pBw, bGroup ? 0 : 3, 6);
+	BW_PushU8(pBw, 0);
+	BW_PushU8(pBw, (uint8_t)(Random(pGenerator) & 0x80));
+	BW_PushBits(pBw, GetAddress(pGenerator, bGroup), 24);
+	BW_PushBits(pBw, GetAddress(pGenerator, false), 24);
+}
+
+// The header carries 6 characters and each of the 3 blocks 7 more
+static void PushAlias(Generator_t *pGenerator, BitWriter_t *pBw)
+{
+	GeneratorAlias_t *pAlias = &pGenerator->Aliases[!pGenerator->bTs];
+	size_t Count = 7;
+	size_t i;
+
+	PushBurst(pGenerator, pBw, 1, true);
+	BW_PushU8(pBw, 9);
+	BW_PushBits(pBw, 0, 2);
+
+	if (!pAlias->Next) {
+		pAlias->bUtf8 = !pAlias->bUtf8;
+		pAlias->Length = (uint8_t)snprintf(pAlias->Text, sizeof(pAlias->Text), pAlias->bUtf8 ? "R\xC3\xA1" "dio %u" : "Radio %u", (unsigned)GetAddress(pGenerator, false));
+		pAlias->Sent = 0;
+		BW_PushBits(pBw, 4, 6);
+		BW_PushU8(pBw, 0);
+		BW_PushBits(pBw, pAlias->bUtf8 ? 2 : 1, 2);
+		BW_PushBits(pBw, pAlias->Length, 5);
+		BW_PushBits(pBw, 0, 1);
+		Count = 6;
+		pAlias->Next = 5;
+	} else {
+		BW_PushBits(pBw, pAlias->Next, 6);
+		BW_PushU8(pBw, 0);
+		pAlias->Next++;
+	}
+
+	for (i = 0; i < Count; i++) {
+		BW_PushU8(pBw, pAlias->Sent < pAlias->Length ? (uint8_t)pAlias->Text[pAlias->Sent] : 0);
+		pAlias->Sent++;
+	}
+	if (pAlias->Sent >= pAlias->Length || pAlias->Next > 7) {
+		pAlias->Next = 0;
+	}
+}
+
+static void PushRecord(Generator_t *pGenerator, BitWriter_t *pBw, GeneratorKind_t Kind)
+{
+	size_t Count;
+	size_t i;
+
+	switch (Kind) {
+	case GENERATOR_CSBK:
+		PushCsbk(pGenerator, pBw);
+		break;
+	case GENERATOR_VOICE_LC:
+		PushCall(pGenerator, pBw, 1);
+		break;
+	case GENERATOR_TERM_LC:
+		PushCall(pGenerator, pBw, 2);
+		break;
+	case GENERATOR_ALIAS:
+		PushAlias(pGenerator, pBw);
+		break;
+	case GENERATOR_CACH:
+		BW_PushU8(pBw, 0x7F);
+		BW_PushU8(pBw, (uint8_t)Random(pGenerator));
+		break;
+	case GENERATOR_CC:
+		BW_PushU8(pBw, 0x77);
+		BW_PushU8(pBw, (uint8_t)(Random(pGenerator) % 16));
+		break;
+	case GENERATOR_BURST:
+		PushBurst(pGenerator, pBw, kBursts[Random(pGenerator) % sizeof(kBursts)], false);
+		for (i = 0; i < 10; i++) {
+			BW_PushU8(pBw, (uint8_t)Random(pGenerator));
+		}
+		break;
+	default:
+		BW_PushU8(pBw, kCommands[Random(pGenerator) % sizeof(kCommands)]);
+		Count = 4 + Random(pGenerator) % 9;
+		for (i = 0; i < Count; i++) {
+			BW_PushU8(pBw, (uint8_t)Random(pGenerator));
+		}
+		break;
+	}
+}
+
+// Public
+
+void GENERATOR_DefaultMix(GeneratorMix_t *pMix)
+{
+	size_t i;
+
+	for (i = 0; i < GENERATOR_KINDS; i++) {
+		pMix->Weights[i] = kKinds[i].Weight;
+	}
+}
+
+bool GENERATOR_ParseMix(const char *pText, GeneratorMix_t *pMix)
+{
+	uint32_t Total = 0;
+	size_t i;
+
+	memset(pMix, 0, sizeof(*pMix));
+
+	while (*pText) {
+		const char *pEqual = strchr(pText, '=');
+		unsigned long Weight;
+		char *pEnd;
+
+		if (!pEqual) {
+			return false;
+		}
+		for (i = 0; i < GENERATOR_KINDS; i++) {
+			if (strlen(kKinds[i].pName) == (size_t)(pEqual - pText) && !strncmp(kKinds[i].pName, pText, (size_t)(pEqual - pText))) {
+				break;
+			}
+		}
+		Weight = strtoul(pEqual + 1, &pEnd, 10);
+		if (i == GENERATOR_KINDS || pEnd == pEqual + 1 || (*pEnd && *pEnd != ',') || Weight > 1000000) {
+			return false;
+		}
+		pMix->Weights[i] = (uint32_t)Weight;
+		pText = *pEnd ? pEnd + 1 : pEnd;
+	}
+
+	for (i = 0; i < GENERATOR_KINDS; i++) {
+		Total += pMix->Weights[i];
+	}
+
+	return Total != 0;
+}
+
+Generator_t *GENERATOR_New(const GeneratorMix_t *pMix, uint32_t Seed)
+{
+	Generator_t *pGenerator;
+	size_t i;
+
+	pGenerator = (Generator_t *)calloc(1, sizeof(Generator_t));
+	if (!pGenerator) {
+		return NULL;
+	}
+
+	pGenerator->Mix = *pMix;
+	for (i = 0; i < GENERATOR_KINDS; i++) {
+		pGenerator->Total += pMix->Weights[i];
+	}
+	if (!pGenerator->Total) {
+		free(pGenerator);
+		return NULL;
+	}
+	pGenerator->State = Seed ? Seed : 1;
+	pGenerator->Opcode = -1;
+
+	return pGenerator;
+}
+
+void GENERATOR_Free(Generator_t *pGenerator)
+{
+	free(pGenerator);
+}
+
+void GENERATOR_SetOpcode(Generator_t *pGenerator, int Opcode)
+{
+	pGenerator->Opcode = Opcode;
+}
+
+size_t GENERATOR_Frame(Generator_t *pGenerator, uint8_t *pFrame, size_t Length)
+{
+	uint8_t Record[64];
+	BitWriter_t Bw;
+	size_t RecordLength;
+
+	BW_Init(&Bw, Record, sizeof(Record));
+	PushRecord(pGenerator, &Bw, GetKind(pGenerator));
+	RecordLength = BW_GetLengthBytes(&Bw);
+	// The length field counts the padding to an even length
+	if (RecordLength % 2) {
+		BW_PushU8(&Bw, 0);
+		RecordLength++;
+	}
+
+	if (6 + RecordLength > Length) {
+		return 0;
+	}
+	BW_Init(&Bw, pFrame, Length);
+	BW_PushBytes(&Bw, kMagic, sizeof(kMagic));
+	BW_PushU16(&Bw, (uint16_t)RecordLength);
+	BW_PushU8(&Bw, 1);
+	BW_PushBytes(&Bw, Record, RecordLength);
+
+	return BW_GetLengthBytes(&Bw);
+}
+
+size_t GENERATOR_Fill(Generator_t *pGenerator, uint8_t *pBuffer, size_t Length, size_t *pFrames)
+{
+	size_t Written = 0;
+	size_t Frames = 0;
+
+	// Frames never exceed ANYTONE_MAX_FRAME_LENGTH, stop once one may not fit
+	while (Length - Written >= ANYTONE_MAX_FRAME_LENGTH) {
+		Written += GENERATOR_Frame(pGenerator, pBuffer + Written, Length - Written);
+		Frames++;
+	}
+	if (pFrames) {
+		*pFrames = Frames;
+	}
+
+	return Written;
+}
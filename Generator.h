@@ -0,0 +1,63 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Builds valid AnyTone frames out of thin air, for benchmarks and for
+// captures to replay without a radio. Each frame carries one record, its
+// kind drawn from a weighted traffic mix.
+enum {
+	GENERATOR_CAPTURE_BYTES = 16 * 1024 * 1024, // Size of the captures written by -g
+};
+
+typedef enum GeneratorKind_t {
+	GENERATOR_CSBK,
+	GENERATOR_VOICE_LC,
+	GENERATOR_TERM_LC,
+	GENERATOR_ALIAS,   // Talker alias header, then its blocks in order
+	GENERATOR_CACH,
+	GENERATOR_CC,
+	GENERATOR_BURST,   // Data burst the decoders keep raw
+	GENERATOR_COMMAND, // Record with a command id the decoders skip
+	GENERATOR_KINDS,
+} GeneratorKind_t;
+
+typedef struct GeneratorMix_t {
+	uint32_t Weights[GENERATOR_KINDS];
+} GeneratorMix_t;
+
+typedef struct Generator_t Generator_t;
+
+// Parses "kind=weight,...", kinds being csbk, voice, term, alias, cach, cc,
+// burst and cmd. Kinds left out are never generated.
+bool GENERATOR_ParseMix(const char *pText, GeneratorMix_t *pMix);
+void GENERATOR_DefaultMix(GeneratorMix_t *pMix);
+
+Generator_t *GENERATOR_New(const GeneratorMix_t *pMix, uint32_t Seed);
+void GENERATOR_Free(Generator_t *pGenerator);
+// Every CSBK gets this opcode, or one drawn at random when negative
+void GENERATOR_SetOpcode(Generator_t *pGenerator, int Opcode);
+// Writes one frame, returns its length or 0 if it does not fit
+size_t GENERATOR_Frame(Generator_t *pGenerator, uint8_t *pFrame, size_t Length);
+// Writes frames back to back while they fit, returns the bytes written
+size_t GENERATOR_Fill(Generator_t *pGenerator, uint8_t *pBuffer, size_t Length, size_t *pFrames);
+
+#endif
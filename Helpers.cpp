@@ -18,18 +18,137 @@
 #include <string.h>
 #include "Helpers.h"
 
-void HEX_Append(char *pLog, size_t LogSize, const char *pHeader, const uint8_t *pData, size_t DataSize)
+// Both digits of every byte value, so each byte is a single 2 byte copy
+static const char kHexPairs[] =
+	"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+	"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+	"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+	"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+	"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+	"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+	"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+	"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+size_t HEX_Encode(char *pOut, size_t OutSize, const uint8_t *pData, size_t DataSize, bool bSpaced)
 {
+	const size_t Width = bSpaced ? 3 : 2;
+	char *pStart = pOut;
 	size_t i;
 
-	if (pHeader) {
-		strcat_s(pLog, LogSize, pHeader);
-		strcat_s(pLog, LogSize, ":");
+	if (DataSize > OutSize / Width) {
+		DataSize = OutSize / Width;
 	}
 
 	for (i = 0; i < DataSize; i++) {
-		char Tmp[8];
-		sprintf_s(Tmp, sizeof(Tmp), " %02X", pData[i]);
-		strcat_s(pLog, LogSize, Tmp);
+		if (bSpaced) {
+			*pOut++ = ' ';
+		}
+		memcpy(pOut, kHexPairs + (pData[i] * 2), 2);
+		pOut += 2;
+	}
+
+	return (size_t)(pOut - pStart);
+}
+
+void HEX_Append(char *pLog, size_t LogSize, const char *pHeader, const uint8_t *pData, size_t DataSize)
+{
+	size_t Length = strnlen(pLog, LogSize);
+
+	if (Length >= LogSize) {
+		return;
 	}
+
+	// The log is only scanned once, everything else is written at the cursor
+	if (pHeader) {
+		const size_t Header = strlen(pHeader);
+
+		if (Length + Header + 1 >= LogSize) {
+			strcat_s(pLog, LogSize, pHeader);
+			return;
+		}
+		memcpy(pLog + Length, pHeader, Header);
+		Length += Header;
+		pLog[Length++] = ':';
+	}
+
+	Length += HEX_Encode(pLog + Length, LogSize - Length - 1, pData, DataSize, true);
+	pLog[Length] = 0;
+}
+
+void PutU16(uint8_t *pBytes, uint16_t Value)
+{
+	pBytes[0] = (uint8_t)Value;
+	pBytes[1] = (uint8_t)(Value >> 8);
+}
+
+void PutU32(uint8_t *pBytes, uint32_t Value)
+{
+	PutU16(pBytes, (uint16_t)Value);
+	PutU16(pBytes + 2, (uint16_t)(Value >> 16));
+}
+
+void PutU64(uint8_t *pBytes, uint64_t Value)
+{
+	PutU32(pBytes, (uint32_t)Value);
+	PutU32(pBytes + 4, (uint32_t)(Value >> 32));
+}
+
+uint16_t GetU16(const uint8_t *pBytes)
+{
+	return (uint16_t)(pBytes[0] | (pBytes[1] << 8));
+}
+
+uint32_t GetU32(const uint8_t *pBytes)
+{
+	return GetU16(pBytes) | ((uint32_t)GetU16(pBytes + 2) << 16);
+}
+
+uint64_t GetU64(const uint8_t *pBytes)
+{
+	return GetU32(pBytes) | ((uint64_t)GetU32(pBytes + 4) << 32);
+}
+
+size_t UTF8_GetLength(const char *pText, size_t Length)
+{
+	const uint8_t *pBytes = (const uint8_t *)pText;
+	uint32_t Code;
+	uint32_t Min;
+	size_t Count;
+	size_t i;
+
+	if (!Length) {
+		return 0;
+	}
+	if (pBytes[0] < 0x80) {
+		return 1;
+	}
+	if ((pBytes[0] & 0xE0) == 0xC0) {
+		Count = 2;
+		Code = pBytes[0] & 0x1F;
+		Min = 0x80;
+	} else if ((pBytes[0] & 0xF0) == 0xE0) {
+		Count = 3;
+		Code = pBytes[0] & 0x0F;
+		Min = 0x800;
+	} else if ((pBytes[0] & 0xF8) == 0xF0) {
+		Count = 4;
+		Code = pBytes[0] & 0x07;
+		Min = 0x10000;
+	} else {
+		return 0;
+	}
+	if (Count > Length) {
+		return 0;
+	}
+	for (i = 1; i < Count; i++) {
+		if ((pBytes[i] & 0xC0) != 0x80) {
+			return 0;
+		}
+		Code = (Code << 6) | (pBytes[i] & 0x3F);
+	}
+	if (Code < Min || Code > 0x10FFFF || (Code >= 0xD800 && Code < 0xE000)) {
+		return 0;
+	}
+
+	return Count;
 }
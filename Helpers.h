@@ -17,8 +17,27 @@
 #ifndef HELPERS_H
 #define HELPERS_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "Platform.h"
 
+// Writes two upper case digits per byte, each preceded by a space if bSpaced.
+// Only whole bytes are written, nothing is terminated. Returns the length.
+size_t HEX_Encode(char *pOut, size_t OutSize, const uint8_t *pData, size_t DataSize, bool bSpaced);
+// Appends "Header:" and " XX" per byte to a terminated log
 void HEX_Append(char *pLog, size_t LogSize, const char *pHeader, const uint8_t *pData, size_t DataSize);
 
+// Little endian fields of the archive and the binary event stream
+void PutU16(uint8_t *pBytes, uint16_t Value);
+void PutU32(uint8_t *pBytes, uint32_t Value);
+void PutU64(uint8_t *pBytes, uint64_t Value);
+uint16_t GetU16(const uint8_t *pBytes);
+uint32_t GetU32(const uint8_t *pBytes);
+uint64_t GetU64(const uint8_t *pBytes);
+
+// Returns the length of the UTF-8 sequence pText starts with, or 0 if it is
+// truncated, overlong, a surrogate or above U+10FFFF
+size_t UTF8_GetLength(const char *pText, size_t Length);
+
 #endif
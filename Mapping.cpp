@@ -0,0 +1,138 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <string.h>
+#include "Mapping.h"
+
+#ifdef _WIN32
+
+bool MAP_Open(Mapping_t *pMap, const char *pPath)
+{
+	LARGE_INTEGER Size;
+	HANDLE hFile;
+	HANDLE hMapping;
+	void *pView;
+
+	memset(pMap, 0, sizeof(*pMap));
+
+	hFile = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	if (!GetFileSizeEx(hFile, &Size) || (uint64_t)Size.QuadPart > (SIZE_MAX >> 1)) {
+		CloseHandle(hFile);
+		return false;
+	}
+
+	if (!Size.QuadPart) {
+		CloseHandle(hFile);
+		return true;
+	}
+
+	hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hMapping) {
+		CloseHandle(hFile);
+		return false;
+	}
+
+	pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!pView) {
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	pMap->pData = (const uint8_t *)pView;
+	pMap->Length = (size_t)Size.QuadPart;
+	pMap->hFile = hFile;
+	pMap->hMapping = hMapping;
+
+	return true;
+}
+
+void MAP_Close(Mapping_t *pMap)
+{
+	if (pMap->pData) {
+		UnmapViewOfFile(pMap->pData);
+	}
+	if (pMap->hMapping) {
+		CloseHandle(pMap->hMapping);
+	}
+	if (pMap->hFile) {
+		CloseHandle(pMap->hFile);
+	}
+	memset(pMap, 0, sizeof(*pMap));
+}
+
+#else
+
+bool MAP_Open(Mapping_t *pMap, const char *pPath)
+{
+	struct stat Stat;
+	void *pView;
+	int Fd;
+
+	memset(pMap, 0, sizeof(*pMap));
+
+	Fd = open(pPath, O_RDONLY | O_CLOEXEC);
+	if (Fd < 0) {
+		return false;
+	}
+
+	if (fstat(Fd, &Stat) < 0) {
+		close(Fd);
+		return false;
+	}
+
+	if (!Stat.st_size) {
+		close(Fd);
+		return true;
+	}
+
+	pView = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+	close(Fd);
+	if (pView == MAP_FAILED) {
+		return false;
+	}
+
+	// The framer walks the file front to back exactly once
+	madvise(pView, (size_t)Stat.st_size, MADV_SEQUENTIAL);
+
+	pMap->pData = (const uint8_t *)pView;
+	pMap->Length = (size_t)Stat.st_size;
+
+	return true;
+}
+
+void MAP_Close(Mapping_t *pMap)
+{
+	if (pMap->pData) {
+		munmap((void *)pMap->pData, pMap->Length);
+	}
+	memset(pMap, 0, sizeof(*pMap));
+}
+
+#endif
@@ -0,0 +1,547 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Clock.h"
+#include "Metrics.h"
+
+#ifdef _WIN32
+typedef SOCKET Socket_t;
+#define CloseSocket closesocket
+#else
+typedef int Socket_t;
+#define INVALID_SOCKET (-1)
+#define CloseSocket close
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Shards hold DecoderStats_t flattened into these slots
+enum {
+	SLOT_BYTES_IN,
+	SLOT_BYTES_DROPPED,
+	SLOT_BYTES_SKIPPED,
+	SLOT_FRAMES,
+	SLOT_RESYNCS,
+	SLOT_BAD_LENGTHS,
+	SLOT_PARTIAL_FRAMES,
+	SLOT_INCOMPLETE_CSBKS,
+	SLOT_PENDING,
+	SLOT_HIGH_WATER,
+	SLOT_FRAME_BYTES,
+	SLOT_GAP_NS,
+	SLOT_COMMANDS,
+	SLOT_CSBKS = SLOT_COMMANDS + 256,
+	SLOT_SIZES = SLOT_CSBKS + 64,
+	SLOT_GAPS = SLOT_SIZES + DECODER_SIZE_BUCKETS,
+	SLOT_COUNT = SLOT_GAPS + DECODER_GAP_BUCKETS,
+};
+
+typedef struct MetricsPort_t {
+	const char *pName;
+	// Only read by the metrics thread, for the deltas of the stats line
+	uint64_t Last[SLOT_COUNT];
+	alignas(64) std::atomic<uint64_t> Slots[SLOT_COUNT];
+} MetricsPort_t;
+
+typedef struct MetricsRing_t {
+	Ring_t *pRing;
+	const char *pName;
+	uint64_t LastDropped;
+} MetricsRing_t;
+
+typedef struct Text_t {
+	char *pText;
+	size_t Length;
+	size_t Size;
+} Text_t;
+
+struct Metrics_t {
+	MetricsPort_t *pPorts[METRICS_MAX_PORTS];
+	size_t PortCount;
+	MetricsRing_t Rings[METRICS_MAX_RINGS];
+	size_t RingCount;
+	Socket_t Listener;
+	uint64_t Interval;
+	std::atomic<bool> bStop;
+	std::thread Thread;
+};
+
+// The counters of the stats line
+static const struct {
+	size_t Slot;
+	const char *pName;
+} kLine[] = {
+	{ SLOT_FRAMES, "frames" },
+	{ SLOT_RESYNCS, "resyncs" },
+	{ SLOT_BAD_LENGTHS, "bad lengths" },
+	{ SLOT_INCOMPLETE_CSBKS, "incomplete CSBKs" },
+	{ SLOT_BYTES_DROPPED, "bytes dropped" },
+};
+
+// The scalars of the scrape
+static const struct {
+	size_t Slot;
+	const char *pName;
+	const char *pType;
+	const char *pHelp;
+} kScalars[] = {
+	{ SLOT_BYTES_IN, "anyti3r_bytes_total", "counter", "Bytes read from the radio." },
+	{ SLOT_BYTES_DROPPED, "anyti3r_dropped_bytes_total", "counter", "Bytes lost to the decoder buffer overflow policy." },
+	{ SLOT_BYTES_SKIPPED, "anyti3r_skipped_bytes_total", "counter", "Bytes discarded by the framer while looking for a frame." },
+	{ SLOT_FRAMES, "anyti3r_frames_total", "counter", "Frames found by the framer." },
+	{ SLOT_RESYNCS, "anyti3r_resyncs_total", "counter", "Times the framer lost sync." },
+	{ SLOT_BAD_LENGTHS, "anyti3r_bad_lengths_total", "counter", "Frame magics rejected for their length field." },
+	{ SLOT_PARTIAL_FRAMES, "anyti3r_partial_frames_total", "counter", "Frame starts cut short by an overflow." },
+	{ SLOT_INCOMPLETE_CSBKS, "anyti3r_incomplete_csbks_total", "counter", "CSBKs cut short by the end of their frame." },
+	{ SLOT_PENDING, "anyti3r_pending_bytes", "gauge", "Bytes queued in the decoder." },
+	{ SLOT_HIGH_WATER, "anyti3r_pending_high_water_bytes", "gauge", "Most bytes ever queued in the decoder." },
+};
+
+// Private
+
+static void Append(Text_t *pText, const char *pFormat, ...)
+{
+	for (;;) {
+		const size_t Free = pText->Size - pText->Length;
+		va_list Args;
+		int Length;
+
+		va_start(Args, pFormat);
+		Length = vsnprintf(pText->pText + pText->Length, Free, pFormat, Args);
+		va_end(Args);
+		if (Length < 0) {
+			return;
+		}
+		if ((size_t)Length < Free) {
+			pText->Length += (size_t)Length;
+			return;
+		}
+
+		char *pGrown = (char *)realloc(pText->pText, pText->Size * 2 + (size_t)Length);
+		if (!pGrown) {
+			return;
+		}
+		pText->pText = pGrown;
+		pText->Size = pText->Size * 2 + (size_t)Length;
+	}
+}
+
+static void Pack(const DecoderStats_t *pStats, uint64_t *pSlots)
+{
+	size_t i;
+
+	pSlots[SLOT_BYTES_IN] = pStats->BytesIn;
+	pSlots[SLOT_BYTES_DROPPED] = pStats->BytesDropped;
+	pSlots[SLOT_BYTES_SKIPPED] = pStats->BytesSkipped;
+	pSlots[SLOT_FRAMES] = pStats->Frames;
+	pSlots[SLOT_RESYNCS] = pStats->Resyncs;
+	pSlots[SLOT_BAD_LENGTHS] = pStats->BadLengths;
+	pSlots[SLOT_PARTIAL_FRAMES] = pStats->PartialFrames;
+	pSlots[SLOT_INCOMPLETE_CSBKS] = pStats->IncompleteCsbks;
+	pSlots[SLOT_PENDING] = pStats->Pending;
+	pSlots[SLOT_HIGH_WATER] = pStats->HighWater;
+	pSlots[SLOT_FRAME_BYTES] = pStats->FrameBytes;
+	pSlots[SLOT_GAP_NS] = pStats->GapNs;
+	for (i = 0; i < 256; i++) {
+		pSlots[SLOT_COMMANDS + i] = pStats->Commands[i];
+	}
+	for (i = 0; i < 64; i++) {
+		pSlots[SLOT_CSBKS + i] = pStats->Csbks[i];
+	}
+	for (i = 0; i < DECODER_SIZE_BUCKETS; i++) {
+		pSlots[SLOT_SIZES + i] = pStats->Sizes[i];
+	}
+	for (i = 0; i < DECODER_GAP_BUCKETS; i++) {
+		pSlots[SLOT_GAPS + i] = pStats->Gaps[i];
+	}
+}
+
+static void Load(const MetricsPort_t *pPort, uint64_t *pSlots)
+{
+	size_t i;
+
+	for (i = 0; i < SLOT_COUNT; i++) {
+		pSlots[i] = pPort->Slots[i].load(std::memory_order_relaxed);
+	}
+}
+
+// Buckets are cumulative in the scrape, bounds double from First
+static void AppendHistogram(Text_t *pText, const char *pName, const char *pPort, const uint64_t *pBuckets, size_t Count, uint64_t Sum, double First, double Scale)
+{
+	uint64_t Total = 0;
+	double Bound = First;
+	size_t i;
+
+	for (i = 0; i < Count - 1; i++) {
+		Total += pBuckets[i];
+		Append(pText, "%s_bucket{port=\"%s\",le=\"%g\"} %llu\n", pName, pPort, Bound, (unsigned long long)Total);
+		Bound *= 2;
+	}
+	Total += pBuckets[Count - 1];
+	Append(pText, "%s_bucket{port=\"%s\",le=\"+Inf\"} %llu\n", pName, pPort, (unsigned long long)Total);
+	Append(pText, "%s_sum{port=\"%s\"} %g\n", pName, pPort, (double)Sum * Scale);
+	Append(pText, "%s_count{port=\"%s\"} %llu\n", pName, pPort, (unsigned long long)Total);
+}
+
+static void Format(Metrics_t *pMetrics, Text_t *pText)
+{
+	// Only the metrics thread formats, this keeps the copy off its stack
+	static uint64_t Slots[METRICS_MAX_PORTS][SLOT_COUNT];
+	size_t i;
+	size_t j;
+
+	// Read every shard once, each metric then uses the same values
+	for (i = 0; i < pMetrics->PortCount; i++) {
+		Load(pMetrics->pPorts[i], Slots[i]);
+	}
+
+	for (j = 0; j < sizeof(kScalars) / sizeof(kScalars[0]); j++) {
+		Append(pText, "# HELP %s %s\n# TYPE %s %s\n", kScalars[j].pName, kScalars[j].pHelp, kScalars[j].pName, kScalars[j].pType);
+		for (i = 0; i < pMetrics->PortCount; i++) {
+			Append(pText, "%s{port=\"%s\"} %llu\n", kScalars[j].pName, pMetrics->pPorts[i]->pName, (unsigned long long)Slots[i][kScalars[j].Slot]);
+		}
+	}
+
+	Append(pText, "# HELP anyti3r_records_total MCU and DMR chip records per command id.\n# TYPE anyti3r_records_total counter\n");
+	for (i = 0; i < pMetrics->PortCount; i++) {
+		for (j = 0; j < 256; j++) {
+			if (Slots[i][SLOT_COMMANDS + j]) {
+				Append(pText, "anyti3r_records_total{port=\"%s\",cmd=\"0x%02X\"} %llu\n", pMetrics->pPorts[i]->pName, (unsigned)j, (unsigned long long)Slots[i][SLOT_COMMANDS + j]);
+			}
+		}
+	}
+
+	Append(pText, "# HELP anyti3r_csbks_total CSBKs per opcode.\n# TYPE anyti3r_csbks_total counter\n");
+	for (i = 0; i < pMetrics->PortCount; i++) {
+		for (j = 0; j < 64; j++) {
+			if (Slots[i][SLOT_CSBKS + j]) {
+				Append(pText, "anyti3r_csbks_total{port=\"%s\",opcode=\"0x%02X\"} %llu\n", pMetrics->pPorts[i]->pName, (unsigned)j, (unsigned long long)Slots[i][SLOT_CSBKS + j]);
+			}
+		}
+	}
+
+	Append(pText, "# HELP anyti3r_frame_size_bytes Length of the frames.\n# TYPE anyti3r_frame_size_bytes histogram\n");
+	for (i = 0; i < pMetrics->PortCount; i++) {
+		AppendHistogram(pText, "anyti3r_frame_size_bytes", pMetrics->pPorts[i]->pName, &Slots[i][SLOT_SIZES], DECODER_SIZE_BUCKETS, Slots[i][SLOT_FRAME_BYTES], DECODER_FIRST_SIZE, 1.0);
+	}
+
+	Append(pText, "# HELP anyti3r_frame_gap_seconds Time between the arrivals of consecutive frames.\n# TYPE anyti3r_frame_gap_seconds histogram\n");
+	for (i = 0; i < pMetrics->PortCount; i++) {
+		AppendHistogram(pText, "anyti3r_frame_gap_seconds", pMetrics->pPorts[i]->pName, &Slots[i][SLOT_GAPS], DECODER_GAP_BUCKETS, Slots[i][SLOT_GAP_NS], DECODER_FIRST_GAP_NS / 1e9, 1e-9);
+	}
+
+	if (pMetrics->RingCount) {
+		RingStats_t Stats[METRICS_MAX_RINGS];
+
+		for (i = 0; i < pMetrics->RingCount; i++) {
+			RING_GetStats(pMetrics->Rings[i].pRing, &Stats[i]);
+		}
+		Append(pText, "# HELP anyti3r_queue_records_total Records through a pipeline queue.\n# TYPE anyti3r_queue_records_total counter\n");
+		for (i = 0; i < pMetrics->RingCount; i++) {
+			Append(pText, "anyti3r_queue_records_total{queue=\"%s\"} %llu\n", pMetrics->Rings[i].pName, (unsigned long long)Stats[i].Records);
+		}
+		Append(pText, "# HELP anyti3r_queue_dropped_total Records a pipeline queue had no room for.\n# TYPE anyti3r_queue_dropped_total counter\n");
+		for (i = 0; i < pMetrics->RingCount; i++) {
+			Append(pText, "anyti3r_queue_dropped_total{queue=\"%s\"} %llu\n", pMetrics->Rings[i].pName, (unsigned long long)Stats[i].Dropped);
+		}
+		Append(pText, "# HELP anyti3r_queue_high_water_bytes Most bytes ever used in a pipeline queue.\n# TYPE anyti3r_queue_high_water_bytes gauge\n");
+		for (i = 0; i < pMetrics->RingCount; i++) {
+			Append(pText, "anyti3r_queue_high_water_bytes{queue=\"%s\"} %zu\n", pMetrics->Rings[i].pName, Stats[i].HighWater);
+		}
+	}
+}
+
+// Totals since the start with the change since the previous line
+static void PrintLine(Metrics_t *pMetrics)
+{
+	char Line[512];
+	size_t i;
+	size_t j;
+
+	for (i = 0; i < pMetrics->PortCount; i++) {
+		MetricsPort_t *pPort = pMetrics->pPorts[i];
+		size_t Length;
+
+		Length = (size_t)snprintf(Line, sizeof(Line), "Metrics %s:", pPort->pName);
+		for (j = 0; j < sizeof(kLine) / sizeof(kLine[0]); j++) {
+			const uint64_t Value = pPort->Slots[kLine[j].Slot].load(std::memory_order_relaxed);
+
+			if (Length < sizeof(Line)) {
+				Length += (size_t)snprintf(Line + Length, sizeof(Line) - Length, "%s %llu %s (+%llu)", j ? "," : "",
+					(unsigned long long)Value, kLine[j].pName, (unsigned long long)(Value - pPort->Last[kLine[j].Slot]));
+			}
+			pPort->Last[kLine[j].Slot] = Value;
+		}
+		fprintf(stderr, "%s\n", Line);
+	}
+
+	for (i = 0; i < pMetrics->RingCount; i++) {
+		MetricsRing_t *pRing = &pMetrics->Rings[i];
+		RingStats_t Stats;
+
+		RING_GetStats(pRing->pRing, &Stats);
+		fprintf(stderr, "Metrics %s queue: %llu records, %llu dropped (+%llu)\n", pRing->pName,
+			(unsigned long long)Stats.Records, (unsigned long long)Stats.Dropped, (unsigned long long)(Stats.Dropped - pRing->LastDropped));
+		pRing->LastDropped = Stats.Dropped;
+	}
+}
+
+// Waits up to TimeoutMs for the socket to become readable
+static bool WaitReadable(Socket_t Socket, uint32_t TimeoutMs)
+{
+	struct timeval Timeout;
+	fd_set Set;
+
+	FD_ZERO(&Set);
+	FD_SET(Socket, &Set);
+	Timeout.tv_sec = TimeoutMs / 1000;
+	Timeout.tv_usec = (TimeoutMs % 1000) * 1000;
+
+	return select((int)Socket + 1, &Set, NULL, NULL, &Timeout) > 0;
+}
+
+static void SendAll(Socket_t Socket, const char *pData, size_t Length)
+{
+	while (Length) {
+		const int Sent = send(Socket, pData, (int)(Length > 65536 ? 65536 : Length), MSG_NOSIGNAL);
+
+		if (Sent <= 0) {
+			return;
+		}
+		pData += Sent;
+		Length -= (size_t)Sent;
+	}
+}
+
+// One request per connection, anything but GET /metrics is not found
+static void Serve(Metrics_t *pMetrics, Socket_t Client)
+{
+	char Request[1024];
+	size_t Length = 0;
+	Text_t Text;
+	char Header[160];
+	int Count;
+
+	while (Length + 1 < sizeof(Request) && WaitReadable(Client, 1000)) {
+		const int Received = recv(Client, Request + Length, (int)(sizeof(Request) - 1 - Length), 0);
+
+		if (Received <= 0) {
+			break;
+		}
+		Length += (size_t)Received;
+		Request[Length] = 0;
+		if (strstr(Request, "\r\n\r\n")) {
+			break;
+		}
+	}
+	Request[Length] = 0;
+
+	if (strncmp(Request, "GET /metrics ", 13) && strncmp(Request, "GET /metrics?", 13)) {
+		static const char kNotFound[] = "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+		SendAll(Client, kNotFound, sizeof(kNotFound) - 1);
+		return;
+	}
+
+	Text.Size = 16384;
+	Text.Length = 0;
+	Text.pText = (char *)malloc(Text.Size);
+	if (!Text.pText) {
+		return;
+	}
+	Text.pText[0] = 0;
+	Format(pMetrics, &Text);
+
+	Count = snprintf(Header, sizeof(Header), "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n", Text.Length);
+	SendAll(Client, Header, (size_t)Count);
+	SendAll(Client, Text.pText, Text.Length);
+	free(Text.pText);
+}
+
+static void Run(Metrics_t *pMetrics)
+{
+	uint64_t Next = CLOCK_GetMonotonic() + pMetrics->Interval;
+
+	while (!pMetrics->bStop.load()) {
+		if (pMetrics->Listener == INVALID_SOCKET) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(METRICS_POLL_MS));
+		} else if (WaitReadable(pMetrics->Listener, METRICS_POLL_MS)) {
+			const Socket_t Client = accept(pMetrics->Listener, NULL, NULL);
+
+			if (Client != INVALID_SOCKET) {
+				Serve(pMetrics, Client);
+				CloseSocket(Client);
+			}
+		}
+
+		if (pMetrics->Interval && CLOCK_GetMonotonic() >= Next) {
+			PrintLine(pMetrics);
+			Next += pMetrics->Interval;
+		}
+	}
+}
+
+static Socket_t Listen(uint16_t TcpPort)
+{
+	struct sockaddr_in Address;
+	Socket_t Socket;
+	int Reuse = 1;
+
+	Socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (Socket == INVALID_SOCKET) {
+		return INVALID_SOCKET;
+	}
+	setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, (const char *)&Reuse, sizeof(Reuse));
+
+	memset(&Address, 0, sizeof(Address));
+	Address.sin_family = AF_INET;
+	Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	Address.sin_port = htons(TcpPort);
+	if (bind(Socket, (const struct sockaddr *)&Address, sizeof(Address)) || listen(Socket, 4)) {
+		CloseSocket(Socket);
+		return INVALID_SOCKET;
+	}
+
+	return Socket;
+}
+
+// Public
+
+Metrics_t *METRICS_New(void)
+{
+	Metrics_t *pMetrics = new (std::nothrow) Metrics_t();
+
+	if (pMetrics) {
+		pMetrics->Listener = INVALID_SOCKET;
+	}
+
+	return pMetrics;
+}
+
+void METRICS_Free(Metrics_t *pMetrics)
+{
+	size_t i;
+
+	if (!pMetrics) {
+		return;
+	}
+	pMetrics->bStop.store(true);
+	if (pMetrics->Thread.joinable()) {
+		pMetrics->Thread.join();
+	}
+	if (pMetrics->Listener != INVALID_SOCKET) {
+		CloseSocket(pMetrics->Listener);
+#ifdef _WIN32
+		WSACleanup();
+#endif
+	}
+	for (i = 0; i < pMetrics->PortCount; i++) {
+		delete pMetrics->pPorts[i];
+	}
+	delete pMetrics;
+}
+
+int METRICS_AddPort(Metrics_t *pMetrics, const char *pName)
+{
+	MetricsPort_t *pPort;
+
+	if (pMetrics->PortCount == METRICS_MAX_PORTS) {
+		return -1;
+	}
+	pPort = new (std::nothrow) MetricsPort_t();
+	if (!pPort) {
+		return -1;
+	}
+	pPort->pName = pName;
+	pMetrics->pPorts[pMetrics->PortCount] = pPort;
+
+	return (int)pMetrics->PortCount++;
+}
+
+bool METRICS_AddRing(Metrics_t *pMetrics, Ring_t *pRing, const char *pName)
+{
+	if (pMetrics->RingCount == METRICS_MAX_RINGS) {
+		return false;
+	}
+	pMetrics->Rings[pMetrics->RingCount].pRing = pRing;
+	pMetrics->Rings[pMetrics->RingCount].pName = pName;
+	pMetrics->RingCount++;
+
+	return true;
+}
+
+void METRICS_Publish(Metrics_t *pMetrics, int Port, const DecoderStats_t *pStats)
+{
+	MetricsPort_t *pPort;
+	uint64_t Slots[SLOT_COUNT];
+	size_t i;
+
+	if (!pMetrics || Port < 0) {
+		return;
+	}
+	pPort = pMetrics->pPorts[Port];
+
+	// Single writer, so plain stores are enough
+	Pack(pStats, Slots);
+	for (i = 0; i < SLOT_COUNT; i++) {
+		pPort->Slots[i].store(Slots[i], std::memory_order_relaxed);
+	}
+}
+
+bool METRICS_Start(Metrics_t *pMetrics, uint16_t TcpPort, uint64_t Interval)
+{
+	if (TcpPort) {
+#ifdef _WIN32
+		WSADATA Data;
+
+		if (WSAStartup(MAKEWORD(2, 2), &Data)) {
+			return false;
+		}
+#endif
+		pMetrics->Listener = Listen(TcpPort);
+		if (pMetrics->Listener == INVALID_SOCKET) {
+#ifdef _WIN32
+			WSACleanup();
+#endif
+			return false;
+		}
+	}
+	pMetrics->Interval = Interval;
+	pMetrics->Thread = std::thread(Run, pMetrics);
+
+	return true;
+}
@@ -0,0 +1,56 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "Decoder.h"
+#include "Ring.h"
+
+// Decoder and queue health for monitoring. Each port has its own shard of
+// counters, only ever written by the thread decoding that port and summed
+// by whoever reads them, so neither side waits on the other.
+//
+// The metrics are served in the Prometheus text format on
+// http://127.0.0.1:port/metrics, and summarised on stderr at an interval.
+enum {
+	METRICS_MAX_PORTS = 64,
+	METRICS_MAX_RINGS = 4,
+	METRICS_POLL_MS = 100,
+};
+
+typedef struct Metrics_t Metrics_t;
+
+Metrics_t *METRICS_New(void);
+// Also stops the server
+void METRICS_Free(Metrics_t *pMetrics);
+
+// Registration comes before METRICS_Start(), names are borrowed. Returns the
+// index to publish the port under, or -1 when full.
+int METRICS_AddPort(Metrics_t *pMetrics, const char *pName);
+bool METRICS_AddRing(Metrics_t *pMetrics, Ring_t *pRing, const char *pName);
+
+// Writer side, copies the decoder counters of a port into its shard
+void METRICS_Publish(Metrics_t *pMetrics, int Port, const DecoderStats_t *pStats);
+
+// Serves the metrics on the loopback interface when TcpPort is not 0, and
+// prints a line per port on stderr every Interval ns when that is not 0
+bool METRICS_Start(Metrics_t *pMetrics, uint16_t TcpPort, uint64_t Interval);
+
+#endif
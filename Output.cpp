@@ -0,0 +1,275 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Clock.h"
+#include "Output.h"
+
+struct Output_t {
+#ifdef _WIN32
+	HANDLE hFile;
+#else
+	int Fd;
+#endif
+	bool bClose;
+	// Kept to open the file again after it was rotated
+	char *pPath;
+	uint64_t Deadline;
+	size_t Length;
+	OutputStats_t Stats;
+	uint8_t Batch[OUTPUT_BATCH_SIZE];
+};
+
+// Private
+
+#ifdef _WIN32
+
+static bool OpenSink(Output_t *pOutput, const char *pPath, uint64_t Preallocate, bool bAppend)
+{
+	FILE_ALLOCATION_INFO Allocation;
+
+	if (!pPath) {
+		pOutput->hFile = GetStdHandle(STD_OUTPUT_HANDLE);
+		return pOutput->hFile && pOutput->hFile != INVALID_HANDLE_VALUE;
+	}
+
+	pOutput->hFile = CreateFileA(pPath, bAppend ? FILE_APPEND_DATA : GENERIC_WRITE, FILE_SHARE_READ, NULL, bAppend ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (pOutput->hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	pOutput->bClose = true;
+
+	// Only a hint, the log still works on file systems that refuse it
+	if (Preallocate) {
+		Allocation.AllocationSize.QuadPart = (LONGLONG)Preallocate;
+		SetFileInformationByHandle(pOutput->hFile, FileAllocationInfo, &Allocation, sizeof(Allocation));
+	}
+
+	return true;
+}
+
+static void CloseSink(Output_t *pOutput)
+{
+	if (pOutput->bClose) {
+		CloseHandle(pOutput->hFile);
+	}
+}
+
+static bool WriteSink(Output_t *pOutput, const uint8_t *pData, size_t Length)
+{
+	while (Length) {
+		DWORD Written;
+
+		if (!WriteFile(pOutput->hFile, pData, (DWORD)Length, &Written, NULL) || !Written) {
+			return false;
+		}
+		pData += Written;
+		Length -= Written;
+	}
+
+	return true;
+}
+
+#else
+
+static bool OpenSink(Output_t *pOutput, const char *pPath, uint64_t Preallocate, bool bAppend)
+{
+	if (!pPath) {
+		pOutput->Fd = STDOUT_FILENO;
+		return true;
+	}
+
+	pOutput->Fd = open(pPath, O_WRONLY | O_CREAT | (bAppend ? O_APPEND : O_TRUNC) | O_CLOEXEC, 0644);
+	if (pOutput->Fd < 0) {
+		return false;
+	}
+	pOutput->bClose = true;
+
+	// Only a hint, the log still works on file systems that refuse it
+	if (Preallocate) {
+#ifdef __linux__
+		fallocate(pOutput->Fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)Preallocate);
+#endif
+	}
+
+	return true;
+}
+
+static void CloseSink(Output_t *pOutput)
+{
+	if (pOutput->bClose) {
+		close(pOutput->Fd);
+	}
+}
+
+static bool WriteSink(Output_t *pOutput, const uint8_t *pData, size_t Length)
+{
+	while (Length) {
+		const ssize_t Written = write(pOutput->Fd, pData, Length);
+
+		if (Written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Written <= 0) {
+			return false;
+		}
+		pData += Written;
+		Length -= (size_t)Written;
+	}
+
+	return true;
+}
+
+#endif
+
+// Public
+
+Output_t *OUTPUT_Open(const char *pPath, uint64_t Preallocate)
+{
+	Output_t *pOutput = (Output_t *)calloc(1, sizeof(Output_t));
+
+	if (!pOutput) {
+		return NULL;
+	}
+
+	if (pPath) {
+		const size_t Length = strlen(pPath) + 1;
+
+		pOutput->pPath = (char *)malloc(Length);
+		if (!pOutput->pPath) {
+			free(pOutput);
+			return NULL;
+		}
+		memcpy(pOutput->pPath, pPath, Length);
+	}
+
+	if (!OpenSink(pOutput, pPath, Preallocate, false)) {
+		free(pOutput->pPath);
+		free(pOutput);
+		return NULL;
+	}
+
+	// Keep whatever was printed before in front of the batched lines
+	fflush(stdout);
+
+	return pOutput;
+}
+
+void OUTPUT_Close(Output_t *pOutput)
+{
+	if (pOutput) {
+		OUTPUT_Flush(pOutput);
+		CloseSink(pOutput);
+		free(pOutput->pPath);
+		free(pOutput);
+	}
+}
+
+bool OUTPUT_Reopen(Output_t *pOutput)
+{
+	bool bOk;
+
+	bOk = OUTPUT_Flush(pOutput);
+	if (!pOutput->pPath) {
+		return bOk;
+	}
+
+	// Until a later reopen works, the writes fail and are counted
+	CloseSink(pOutput);
+	pOutput->bClose = false;
+	if (!OpenSink(pOutput, pOutput->pPath, 0, true)) {
+		pOutput->Stats.Errors++;
+		return false;
+	}
+
+	return bOk;
+}
+
+bool OUTPUT_Write(Output_t *pOutput, const void *pData, size_t Length)
+{
+	bool bOk = true;
+
+	if (pOutput->Length + Length > sizeof(pOutput->Batch)) {
+		bOk = OUTPUT_Flush(pOutput);
+	}
+
+	// Lines larger than a whole batch skip the copy
+	if (Length > sizeof(pOutput->Batch)) {
+		pOutput->Stats.Writes++;
+		if (!WriteSink(pOutput, (const uint8_t *)pData, Length)) {
+			pOutput->Stats.Errors++;
+			return false;
+		}
+		pOutput->Stats.Bytes += Length;
+		return bOk;
+	}
+
+	if (!pOutput->Length) {
+		pOutput->Deadline = CLOCK_GetMonotonic() + OUTPUT_DEADLINE_MS * 1000000ULL;
+	}
+	memcpy(pOutput->Batch + pOutput->Length, pData, Length);
+	pOutput->Length += Length;
+
+	if (pOutput->Length == sizeof(pOutput->Batch)) {
+		return OUTPUT_Flush(pOutput) && bOk;
+	}
+
+	return bOk;
+}
+
+bool OUTPUT_Poll(Output_t *pOutput, uint64_t Now)
+{
+	if (!pOutput->Length || Now < pOutput->Deadline) {
+		return true;
+	}
+
+	return OUTPUT_Flush(pOutput);
+}
+
+bool OUTPUT_Flush(Output_t *pOutput)
+{
+	const size_t Length = pOutput->Length;
+
+	if (!Length) {
+		return true;
+	}
+
+	// A failed batch is dropped rather than retried forever
+	pOutput->Length = 0;
+	pOutput->Stats.Writes++;
+	if (!WriteSink(pOutput, pOutput->Batch, Length)) {
+		pOutput->Stats.Errors++;
+		return false;
+	}
+	pOutput->Stats.Bytes += Length;
+
+	return true;
+}
+
+void OUTPUT_GetStats(const Output_t *pOutput, OutputStats_t *pStats)
+{
+	*pStats = pOutput->Stats;
+}
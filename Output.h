@@ -0,0 +1,55 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Batches decoded lines into large writes. A batch is written once it holds
+// OUTPUT_BATCH_SIZE bytes, or by OUTPUT_Poll() once its oldest line has waited
+// OUTPUT_DEADLINE_MS.
+enum {
+	OUTPUT_BATCH_SIZE = 64 * 1024,
+	OUTPUT_DEADLINE_MS = 50,
+};
+
+typedef struct OutputStats_t {
+	uint64_t Bytes;
+	uint64_t Writes;
+	uint64_t Errors;
+} OutputStats_t;
+
+typedef struct Output_t Output_t;
+
+// A NULL path writes to stdout. Otherwise the file is truncated and, when
+// Preallocate is not 0, that many bytes are reserved on disk up front without
+// changing the file size.
+Output_t *OUTPUT_Open(const char *pPath, uint64_t Preallocate);
+void OUTPUT_Close(Output_t *pOutput);
+// Flushes, then opens the file again for appending, once it was rotated
+bool OUTPUT_Reopen(Output_t *pOutput);
+
+bool OUTPUT_Write(Output_t *pOutput, const void *pData, size_t Length);
+// Writes the pending batch if it is older than the deadline
+bool OUTPUT_Poll(Output_t *pOutput, uint64_t Now);
+bool OUTPUT_Flush(Output_t *pOutput);
+
+void OUTPUT_GetStats(const Output_t *pOutput, OutputStats_t *pStats);
+
+#endif
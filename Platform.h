@@ -0,0 +1,79 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#ifndef _WIN32
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// The decoders use the MSVC bounds checked CRT functions. Map them onto their
+// POSIX equivalents so the same sources build with GCC and Clang.
+
+#define sscanf_s sscanf
+
+// Like MSVC, a truncated result empties the buffer and returns -1, so callers
+// never see the length snprintf() would have written
+static inline int sprintf_s(char *pBuffer, size_t Size, const char *pFormat, ...) __attribute__((format(printf, 3, 4)));
+static inline int sprintf_s(char *pBuffer, size_t Size, const char *pFormat, ...)
+{
+	va_list Args;
+	int Length;
+
+	va_start(Args, pFormat);
+	Length = vsnprintf(pBuffer, Size, pFormat, Args);
+	va_end(Args);
+
+	if (Length < 0 || (size_t)Length >= Size) {
+		if (Size) {
+			pBuffer[0] = 0;
+		}
+		return -1;
+	}
+
+	return Length;
+}
+
+static inline int strcat_s(char *pDst, size_t DstSize, const char *pSrc)
+{
+	const size_t Length = strnlen(pDst, DstSize);
+
+	if (Length < DstSize) {
+		snprintf(pDst + Length, DstSize - Length, "%s", pSrc);
+	}
+
+	return 0;
+}
+
+static inline int fopen_s(FILE **ppFile, const char *pPath, const char *pMode)
+{
+	*ppFile = fopen(pPath, pMode);
+
+	return *ppFile ? 0 : -1;
+}
+
+static inline int localtime_s(struct tm *pTm, const time_t *pTime)
+{
+	return localtime_r(pTime, pTm) ? 0 : -1;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,260 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include "Ring.h"
+
+enum {
+	RING_HEADER = 8,
+	// Header of the padding left at the end when a record starts over
+	RING_WRAP = 0xFFFFFFFF,
+};
+
+struct Ring_t {
+	// Producer side
+	alignas(64) std::atomic<uint64_t> Head;
+	uint64_t Pending;
+	uint64_t TailCache;
+	// Consumer side
+	alignas(64) std::atomic<uint64_t> Tail;
+	uint64_t Next;
+	uint64_t HeadCache;
+	// Stats are only written by the producer but may be read from anywhere
+	alignas(64) std::atomic<uint64_t> Records;
+	std::atomic<uint64_t> Dropped;
+	std::atomic<uint64_t> DroppedBytes;
+	std::atomic<size_t> HighWater;
+	// Wake ups. The mutex is only taken when the other side is about to
+	// sleep, so a producer is never held up by a busy consumer.
+	std::atomic<bool> bClosed;
+	std::atomic<bool> bProducerWaiting;
+	std::atomic<bool> bConsumerWaiting;
+	std::mutex Mutex;
+	std::condition_variable Event;
+	RingPolicy_t Policy;
+	size_t Size;
+	uint8_t *pData;
+};
+
+// Private
+
+static size_t GetRecordSize(size_t Length)
+{
+	return RING_HEADER + ((Length + 7) & ~(size_t)7);
+}
+
+// Pairs with the store of the waiting flag in Wait(): either the waiter sees
+// the update or the waker sees the flag.
+static void Wake(Ring_t *pRing, std::atomic<bool> &bWaiting)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (bWaiting.load()) {
+		// Taking the mutex makes sure the waiter is really asleep
+		std::lock_guard<std::mutex> Lock(pRing->Mutex);
+		pRing->Event.notify_all();
+	}
+}
+
+template <typename Predicate>
+static void Wait(Ring_t *pRing, std::atomic<bool> &bWaiting, uint32_t TimeoutMs, Predicate Ready)
+{
+	std::unique_lock<std::mutex> Lock(pRing->Mutex);
+
+	bWaiting.store(true);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	pRing->Event.wait_for(Lock, std::chrono::milliseconds(TimeoutMs), Ready);
+	bWaiting.store(false);
+}
+
+// Public
+
+Ring_t *RING_New(size_t Size, RingPolicy_t Policy)
+{
+	Ring_t *pRing;
+	size_t Power = 4096;
+
+	while (Power < Size) {
+		Power *= 2;
+	}
+
+	pRing = new (std::nothrow) Ring_t();
+	if (!pRing) {
+		return NULL;
+	}
+	pRing->pData = (uint8_t *)malloc(Power);
+	if (!pRing->pData) {
+		delete pRing;
+		return NULL;
+	}
+	pRing->Size = Power;
+	pRing->Policy = Policy;
+
+	return pRing;
+}
+
+void RING_Free(Ring_t *pRing)
+{
+	if (pRing) {
+		free(pRing->pData);
+		delete pRing;
+	}
+}
+
+void *RING_Reserve(Ring_t *pRing, size_t Length)
+{
+	const size_t Need = GetRecordSize(Length);
+	uint64_t Head = pRing->Head.load(std::memory_order_relaxed);
+	size_t Position = (size_t)(Head & (pRing->Size - 1));
+	size_t Pad = 0;
+	uint32_t Header;
+
+	if (Position + Need > pRing->Size) {
+		Pad = pRing->Size - Position;
+	}
+
+	for (;;) {
+		if (Head + Pad + Need - pRing->TailCache <= pRing->Size) {
+			break;
+		}
+		pRing->TailCache = pRing->Tail.load(std::memory_order_acquire);
+		if (Head + Pad + Need - pRing->TailCache <= pRing->Size) {
+			break;
+		}
+		// A record larger than half the ring could never be guaranteed to fit
+		if (pRing->bClosed.load() || pRing->Policy == RING_DROP || Need > pRing->Size / 2) {
+			pRing->Dropped.fetch_add(1, std::memory_order_relaxed);
+			pRing->DroppedBytes.fetch_add(Length, std::memory_order_relaxed);
+			return NULL;
+		}
+		Wait(pRing, pRing->bProducerWaiting, 10, [&] {
+			return Head + Pad + Need - pRing->Tail.load(std::memory_order_acquire) <= pRing->Size;
+		});
+	}
+
+	if (Pad) {
+		Header = RING_WRAP;
+		memcpy(pRing->pData + Position, &Header, sizeof(Header));
+		Head += Pad;
+		Position = 0;
+	}
+
+	Header = (uint32_t)Length;
+	memcpy(pRing->pData + Position, &Header, sizeof(Header));
+	pRing->Pending = Head + Need;
+
+	return pRing->pData + Position + RING_HEADER;
+}
+
+void RING_Commit(Ring_t *pRing)
+{
+	const size_t Used = (size_t)(pRing->Pending - pRing->TailCache);
+
+	pRing->Head.store(pRing->Pending, std::memory_order_release);
+	pRing->Records.fetch_add(1, std::memory_order_relaxed);
+	// Measured against the last tail the producer saw, so it never underestimates
+	if (pRing->HighWater.load(std::memory_order_relaxed) < Used) {
+		pRing->HighWater.store(Used, std::memory_order_relaxed);
+	}
+	Wake(pRing, pRing->bConsumerWaiting);
+}
+
+bool RING_Push(Ring_t *pRing, const void *pData, size_t Length)
+{
+	void *pRecord = RING_Reserve(pRing, Length);
+
+	if (!pRecord) {
+		return false;
+	}
+	memcpy(pRecord, pData, Length);
+	RING_Commit(pRing);
+
+	return true;
+}
+
+void RING_Close(Ring_t *pRing)
+{
+	std::lock_guard<std::mutex> Lock(pRing->Mutex);
+
+	pRing->bClosed.store(true);
+	pRing->Event.notify_all();
+}
+
+const void *RING_Peek(Ring_t *pRing, size_t *pLength, uint32_t TimeoutMs)
+{
+	uint64_t Tail = pRing->Tail.load(std::memory_order_relaxed);
+
+	for (;;) {
+		if (pRing->HeadCache == Tail) {
+			pRing->HeadCache = pRing->Head.load(std::memory_order_acquire);
+		}
+
+		if (pRing->HeadCache != Tail) {
+			const size_t Position = (size_t)(Tail & (pRing->Size - 1));
+			uint32_t Header;
+
+			memcpy(&Header, pRing->pData + Position, sizeof(Header));
+			if (Header == RING_WRAP) {
+				Tail += pRing->Size - Position;
+				pRing->Tail.store(Tail, std::memory_order_release);
+				continue;
+			}
+
+			*pLength = Header;
+			pRing->Next = Tail + GetRecordSize(Header);
+
+			return pRing->pData + Position + RING_HEADER;
+		}
+
+		// Records pushed right before closing must still come out
+		if (!TimeoutMs || pRing->bClosed.load()) {
+			if (pRing->Head.load(std::memory_order_acquire) != Tail) {
+				continue;
+			}
+			return NULL;
+		}
+
+		Wait(pRing, pRing->bConsumerWaiting, TimeoutMs, [&] {
+			return pRing->bClosed.load() || pRing->Head.load(std::memory_order_acquire) != Tail;
+		});
+		TimeoutMs = 0;
+	}
+}
+
+void RING_Release(Ring_t *pRing)
+{
+	pRing->Tail.store(pRing->Next, std::memory_order_release);
+	Wake(pRing, pRing->bProducerWaiting);
+}
+
+bool RING_IsDone(Ring_t *pRing)
+{
+	return pRing->bClosed.load() && pRing->Head.load(std::memory_order_acquire) == pRing->Tail.load(std::memory_order_relaxed);
+}
+
+void RING_GetStats(Ring_t *pRing, RingStats_t *pStats)
+{
+	pStats->Records = pRing->Records.load(std::memory_order_relaxed);
+	pStats->Dropped = pRing->Dropped.load(std::memory_order_relaxed);
+	pStats->DroppedBytes = pRing->DroppedBytes.load(std::memory_order_relaxed);
+	pStats->HighWater = pRing->HighWater.load(std::memory_order_relaxed);
+	pStats->Size = pRing->Size;
+}
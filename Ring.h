@@ -0,0 +1,65 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RING_H
+#define RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bounded single producer, single consumer queue of variable length records.
+// Records are contiguous in memory, a record that would straddle the end of
+// the ring starts over at its beginning instead.
+
+// What the producer does when a record does not fit
+typedef enum RingPolicy_t {
+	RING_DROP,  // Drop the new record and count it, never waits
+	RING_BLOCK, // Wait for the consumer to make room
+} RingPolicy_t;
+
+typedef struct RingStats_t {
+	uint64_t Records;
+	uint64_t Dropped;
+	uint64_t DroppedBytes;
+	size_t HighWater;
+	size_t Size;
+} RingStats_t;
+
+typedef struct Ring_t Ring_t;
+
+// Size is rounded up to a power of two
+Ring_t *RING_New(size_t Size, RingPolicy_t Policy);
+void RING_Free(Ring_t *pRing);
+
+// Producer side. RING_Reserve() returns NULL when the record was dropped or
+// the ring is closed, otherwise RING_Commit() publishes it.
+void *RING_Reserve(Ring_t *pRing, size_t Length);
+void RING_Commit(Ring_t *pRing);
+bool RING_Push(Ring_t *pRing, const void *pData, size_t Length);
+// No more records will be pushed, wakes up the consumer
+void RING_Close(Ring_t *pRing);
+
+// Consumer side. RING_Peek() waits up to TimeoutMs for a record and returns
+// NULL if there is none. RING_Release() hands the record back to the producer.
+const void *RING_Peek(Ring_t *pRing, size_t *pLength, uint32_t TimeoutMs);
+void RING_Release(Ring_t *pRing);
+// True once the ring is closed and every record was consumed
+bool RING_IsDone(Ring_t *pRing);
+
+void RING_GetStats(Ring_t *pRing, RingStats_t *pStats);
+
+#endif
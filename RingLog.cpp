@@ -0,0 +1,513 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "RingLog.h"
+
+enum {
+	RINGLOG_VERSION = 1,
+	// Keeps the records page aligned
+	RINGLOG_HEADER_SIZE = 4096,
+	RINGLOG_RECORD_SIZE = 24,
+};
+
+static const char kRingLogMagic[4] = { 'A', 'T', '3', 'R' };
+
+typedef struct RingLogHeader_t {
+	char Magic[4];
+	uint16_t Version;
+	uint16_t HeaderSize;
+	uint64_t Size;
+	uint64_t Head;
+	uint64_t Tail;
+	uint64_t Records;
+	uint64_t Sequence;
+} RingLogHeader_t;
+
+typedef struct RingLogEntry_t {
+	uint32_t Length;
+	uint8_t Type;
+	uint8_t Port;
+	uint16_t Reserved;
+	uint64_t Sequence;
+	uint64_t Realtime;
+} RingLogEntry_t;
+
+static_assert(sizeof(RingLogEntry_t) == RINGLOG_RECORD_SIZE, "Ring log record header");
+
+struct RingLog_t {
+	char *pPath;
+	uint64_t Size;
+#ifdef _WIN32
+	HANDLE hFile;
+	HANDLE hMapping;
+#endif
+	uint8_t *pView;
+	size_t ViewLength;
+	RingLogHeader_t *pHeader;
+	uint8_t *pRecords;
+	// Record bytes touched since the last sync
+	uint64_t DirtyLow;
+	uint64_t DirtyHigh;
+	uint64_t NextSync;
+	RingLogStats_t Stats;
+};
+
+// Private
+
+#ifdef _WIN32
+
+static bool MapFile(RingLog_t *pLog, bool *pbCreated)
+{
+	LARGE_INTEGER Size;
+
+	pLog->hFile = CreateFileA(pLog->pPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (pLog->hFile == INVALID_HANDLE_VALUE) {
+		pLog->hFile = NULL;
+		return false;
+	}
+
+	if (!GetFileSizeEx(pLog->hFile, &Size) || (uint64_t)Size.QuadPart > (SIZE_MAX >> 1)) {
+		CloseHandle(pLog->hFile);
+		pLog->hFile = NULL;
+		return false;
+	}
+
+	// Extending the file allocates the clusters, the log never grows later
+	if (!Size.QuadPart) {
+		Size.QuadPart = (LONGLONG)(RINGLOG_HEADER_SIZE + pLog->Size);
+		if (!SetFilePointerEx(pLog->hFile, Size, NULL, FILE_BEGIN) || !SetEndOfFile(pLog->hFile)) {
+			CloseHandle(pLog->hFile);
+			pLog->hFile = NULL;
+			return false;
+		}
+		*pbCreated = true;
+	}
+
+	pLog->hMapping = CreateFileMappingA(pLog->hFile, NULL, PAGE_READWRITE, 0, 0, NULL);
+	if (!pLog->hMapping) {
+		CloseHandle(pLog->hFile);
+		pLog->hFile = NULL;
+		return false;
+	}
+
+	pLog->pView = (uint8_t *)MapViewOfFile(pLog->hMapping, FILE_MAP_WRITE, 0, 0, 0);
+	if (!pLog->pView) {
+		CloseHandle(pLog->hMapping);
+		CloseHandle(pLog->hFile);
+		pLog->hMapping = NULL;
+		pLog->hFile = NULL;
+		return false;
+	}
+	pLog->ViewLength = (size_t)Size.QuadPart;
+
+	return true;
+}
+
+static void UnmapFile(RingLog_t *pLog)
+{
+	if (pLog->pView) {
+		UnmapViewOfFile(pLog->pView);
+	}
+	if (pLog->hMapping) {
+		CloseHandle(pLog->hMapping);
+	}
+	if (pLog->hFile) {
+		CloseHandle(pLog->hFile);
+	}
+	pLog->pView = NULL;
+	pLog->hMapping = NULL;
+	pLog->hFile = NULL;
+}
+
+static bool SyncView(RingLog_t *pLog, size_t Offset, size_t Length)
+{
+	return FlushViewOfFile(pLog->pView + Offset, Length) && FlushFileBuffers(pLog->hFile);
+}
+
+#else
+
+static bool MapFile(RingLog_t *pLog, bool *pbCreated)
+{
+	struct stat Stat;
+	size_t Length;
+	void *pView;
+	int Fd;
+
+	Fd = open(pLog->pPath, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (Fd < 0) {
+		return false;
+	}
+
+	if (fstat(Fd, &Stat) < 0) {
+		close(Fd);
+		return false;
+	}
+	Length = (size_t)Stat.st_size;
+
+	// Stores into a hole raise SIGBUS once the disk is full, so the blocks
+	// are claimed now rather than on the hot path
+	if (!Length) {
+		Length = (size_t)(RINGLOG_HEADER_SIZE + pLog->Size);
+#ifdef __linux__
+		if (posix_fallocate(Fd, 0, (off_t)Length)) {
+#else
+		if (ftruncate(Fd, (off_t)Length) < 0) {
+#endif
+			// It was empty, the next open starts over
+			unlink(pLog->pPath);
+			close(Fd);
+			return false;
+		}
+		*pbCreated = true;
+	}
+
+	pView = mmap(NULL, Length, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+	close(Fd);
+	if (pView == MAP_FAILED) {
+		return false;
+	}
+
+	pLog->pView = (uint8_t *)pView;
+	pLog->ViewLength = Length;
+
+	return true;
+}
+
+static void UnmapFile(RingLog_t *pLog)
+{
+	if (pLog->pView) {
+		munmap(pLog->pView, pLog->ViewLength);
+	}
+	pLog->pView = NULL;
+}
+
+static bool SyncView(RingLog_t *pLog, size_t Offset, size_t Length)
+{
+	const size_t Page = (size_t)sysconf(_SC_PAGESIZE);
+	const size_t Start = Offset - (Offset % Page);
+
+	return !msync(pLog->pView + Start, Length + (Offset - Start), MS_SYNC);
+}
+
+#endif
+
+static uint64_t Align(uint64_t Length)
+{
+	return (Length + 7) & ~7ULL;
+}
+
+// A record header that does not fit before the end, or a WRAP record, means
+// the next record is at the start
+static uint64_t Normalize(const uint8_t *pRecords, uint64_t Size, uint64_t Offset)
+{
+	if (Offset + RINGLOG_RECORD_SIZE > Size || pRecords[Offset + 4] == RINGLOG_WRAP) {
+		return 0;
+	}
+
+	return Offset;
+}
+
+static bool GetEntry(const uint8_t *pRecords, uint64_t Size, uint64_t Offset, RingLogEntry_t *pEntry)
+{
+	if (Offset + RINGLOG_RECORD_SIZE > Size) {
+		return false;
+	}
+	memcpy(pEntry, pRecords + Offset, sizeof(*pEntry));
+
+	return pEntry->Type < RINGLOG_WRAP && pEntry->Length <= RINGLOG_MAX_RECORD && Offset + RINGLOG_RECORD_SIZE + pEntry->Length <= Size;
+}
+
+static void MarkDirty(RingLog_t *pLog, uint64_t Offset, uint64_t Length)
+{
+	if (Offset < pLog->DirtyLow) {
+		pLog->DirtyLow = Offset;
+	}
+	if (Offset + Length > pLog->DirtyHigh) {
+		pLog->DirtyHigh = Offset + Length;
+	}
+}
+
+static void DropTail(RingLog_t *pLog)
+{
+	RingLogHeader_t *pHeader = pLog->pHeader;
+	RingLogEntry_t Entry;
+
+	// A damaged record loses the rest of the history rather than the log
+	if (!GetEntry(pLog->pRecords, pHeader->Size, pHeader->Tail, &Entry)) {
+		pLog->Stats.Overwritten += pHeader->Records;
+		pHeader->Records = 0;
+		pHeader->Tail = pHeader->Head;
+		return;
+	}
+
+	pHeader->Tail = Normalize(pLog->pRecords, pHeader->Size, pHeader->Tail + Align(RINGLOG_RECORD_SIZE + Entry.Length));
+	pHeader->Records--;
+	pLog->Stats.Overwritten++;
+}
+
+static bool MapLog(RingLog_t *pLog)
+{
+	RingLogHeader_t *pHeader;
+	bool bCreated = false;
+
+	if (!MapFile(pLog, &bCreated)) {
+		return false;
+	}
+
+	pHeader = (RingLogHeader_t *)pLog->pView;
+	if (bCreated) {
+		memset(pHeader, 0, sizeof(*pHeader));
+		memcpy(pHeader->Magic, kRingLogMagic, sizeof(kRingLogMagic));
+		pHeader->Version = RINGLOG_VERSION;
+		pHeader->HeaderSize = RINGLOG_HEADER_SIZE;
+		pHeader->Size = (pLog->ViewLength - RINGLOG_HEADER_SIZE) & ~7ULL;
+		SyncView(pLog, 0, RINGLOG_HEADER_SIZE);
+	} else if (!RINGLOG_IsRingLog(pLog->pView, pLog->ViewLength)) {
+		UnmapFile(pLog);
+		return false;
+	}
+
+	pLog->pHeader = pHeader;
+	pLog->pRecords = pLog->pView + RINGLOG_HEADER_SIZE;
+	pLog->DirtyLow = UINT64_MAX;
+	pLog->DirtyHigh = 0;
+
+	return true;
+}
+
+// Public
+
+RingLog_t *RINGLOG_Open(const char *pPath, uint64_t Size)
+{
+	RingLog_t *pLog = (RingLog_t *)calloc(1, sizeof(RingLog_t));
+	const size_t Length = strlen(pPath) + 1;
+
+	if (!pLog) {
+		return NULL;
+	}
+
+	pLog->pPath = (char *)malloc(Length);
+	if (!pLog->pPath) {
+		free(pLog);
+		return NULL;
+	}
+	memcpy(pLog->pPath, pPath, Length);
+
+	pLog->Size = Size < RINGLOG_MIN_SIZE ? (uint64_t)RINGLOG_MIN_SIZE : Size & ~7ULL;
+	if (!MapLog(pLog)) {
+		free(pLog->pPath);
+		free(pLog);
+		return NULL;
+	}
+
+	return pLog;
+}
+
+void RINGLOG_Close(RingLog_t *pLog)
+{
+	if (pLog) {
+		RINGLOG_Sync(pLog);
+		UnmapFile(pLog);
+		free(pLog->pPath);
+		free(pLog);
+	}
+}
+
+bool RINGLOG_Reopen(RingLog_t *pLog)
+{
+	RINGLOG_Sync(pLog);
+	UnmapFile(pLog);
+	pLog->pHeader = NULL;
+	pLog->pRecords = NULL;
+
+	return MapLog(pLog);
+}
+
+bool RINGLOG_Append(RingLog_t *pLog, uint8_t Type, uint8_t Port, uint64_t Realtime, const void *pData, size_t Length)
+{
+	RingLogHeader_t *pHeader = pLog->pHeader;
+	const uint64_t Need = Align(RINGLOG_RECORD_SIZE + Length);
+	RingLogEntry_t Entry;
+	uint64_t Position;
+
+	if (!pHeader || Type >= RINGLOG_WRAP || Length > RINGLOG_MAX_RECORD) {
+		return false;
+	}
+
+	memset(&Entry, 0, sizeof(Entry));
+
+	Position = pHeader->Head;
+	if (Position + Need > pHeader->Size) {
+		// Records between Head and the end go with the wrap
+		while (pHeader->Records && pHeader->Tail >= Position) {
+			DropTail(pLog);
+		}
+		if (Position + RINGLOG_RECORD_SIZE <= pHeader->Size) {
+			Entry.Type = RINGLOG_WRAP;
+			memcpy(pLog->pRecords + Position, &Entry, sizeof(Entry));
+			MarkDirty(pLog, Position, sizeof(Entry));
+		}
+		Position = 0;
+		pHeader->Head = 0;
+		pLog->Stats.Wraps++;
+	}
+
+	// Make room by overwriting the oldest records
+	while (pHeader->Records && pHeader->Tail >= Position && pHeader->Tail < Position + Need) {
+		DropTail(pLog);
+	}
+	if (!pHeader->Records) {
+		pHeader->Tail = Position;
+	}
+
+	Entry.Length = (uint32_t)Length;
+	Entry.Type = Type;
+	Entry.Port = Port;
+	Entry.Sequence = pHeader->Sequence;
+	Entry.Realtime = Realtime;
+	memcpy(pLog->pRecords + Position, &Entry, sizeof(Entry));
+	memcpy(pLog->pRecords + Position + sizeof(Entry), pData, Length);
+	MarkDirty(pLog, Position, Need);
+
+	// Only now is the record part of the log
+	pHeader->Head = Position + Need;
+	pHeader->Sequence++;
+	pHeader->Records++;
+
+	pLog->Stats.Appended++;
+	pLog->Stats.Newest = Realtime;
+
+	return true;
+}
+
+void RINGLOG_Poll(RingLog_t *pLog, uint64_t Now)
+{
+	if (!pLog->NextSync) {
+		pLog->NextSync = Now + RINGLOG_SYNC_MS * 1000000ULL;
+	} else if (Now >= pLog->NextSync) {
+		RINGLOG_Sync(pLog);
+		pLog->NextSync = Now + RINGLOG_SYNC_MS * 1000000ULL;
+	}
+}
+
+bool RINGLOG_Sync(RingLog_t *pLog)
+{
+	bool bOk;
+
+	if (!pLog->pHeader || pLog->DirtyLow >= pLog->DirtyHigh) {
+		return true;
+	}
+
+	// Records first, so the header on disk never points past them
+	bOk = SyncView(pLog, (size_t)(RINGLOG_HEADER_SIZE + pLog->DirtyLow), (size_t)(pLog->DirtyHigh - pLog->DirtyLow));
+	bOk = SyncView(pLog, 0, RINGLOG_HEADER_SIZE) && bOk;
+	pLog->DirtyLow = UINT64_MAX;
+	pLog->DirtyHigh = 0;
+	pLog->Stats.Syncs++;
+
+	return bOk;
+}
+
+void RINGLOG_GetStats(const RingLog_t *pLog, RingLogStats_t *pStats)
+{
+	const RingLogHeader_t *pHeader = pLog->pHeader;
+	RingLogEntry_t Entry;
+
+	*pStats = pLog->Stats;
+	if (!pHeader) {
+		return;
+	}
+
+	pStats->Size = pHeader->Size;
+	pStats->Records = pHeader->Records;
+	if (pHeader->Records && GetEntry(pLog->pRecords, pHeader->Size, pHeader->Tail, &Entry)) {
+		pStats->Oldest = Entry.Realtime;
+	}
+}
+
+bool RINGLOG_IsRingLog(const uint8_t *pData, size_t Length)
+{
+	RingLogHeader_t Header;
+
+	if (Length < RINGLOG_HEADER_SIZE) {
+		return false;
+	}
+	memcpy(&Header, pData, sizeof(Header));
+
+	return !memcmp(Header.Magic, kRingLogMagic, sizeof(kRingLogMagic))
+		&& Header.Version == RINGLOG_VERSION
+		&& Header.HeaderSize == RINGLOG_HEADER_SIZE
+		&& Header.Size >= RINGLOG_RECORD_SIZE
+		&& !(Header.Size & 7)
+		&& Header.Size <= Length - RINGLOG_HEADER_SIZE
+		&& Header.Head <= Header.Size
+		&& Header.Tail < Header.Size
+		&& !((Header.Head | Header.Tail) & 7);
+}
+
+void RINGLOG_Rewind(const uint8_t *pData, RingLogCursor_t *pCursor)
+{
+	RingLogHeader_t Header;
+
+	memcpy(&Header, pData, sizeof(Header));
+	pCursor->Offset = Header.Tail;
+	pCursor->Left = Header.Records;
+}
+
+bool RINGLOG_Next(const uint8_t *pData, size_t Length, RingLogCursor_t *pCursor, RingLogRecord_t *pRecord)
+{
+	const uint8_t *pRecords = pData + RINGLOG_HEADER_SIZE;
+	RingLogHeader_t Header;
+	RingLogEntry_t Entry;
+	uint64_t Offset;
+
+	if (!pCursor->Left) {
+		return false;
+	}
+	memcpy(&Header, pData, sizeof(Header));
+	if (Header.Size > Length - RINGLOG_HEADER_SIZE || pCursor->Offset > Header.Size) {
+		return false;
+	}
+
+	Offset = Normalize(pRecords, Header.Size, pCursor->Offset);
+	if (!GetEntry(pRecords, Header.Size, Offset, &Entry)) {
+		pCursor->Left = 0;
+		return false;
+	}
+
+	pRecord->Sequence = Entry.Sequence;
+	pRecord->Realtime = Entry.Realtime;
+	pRecord->pData = pRecords + Offset + RINGLOG_RECORD_SIZE;
+	pRecord->Length = Entry.Length;
+	pRecord->Type = Entry.Type;
+	pRecord->Port = Entry.Port;
+
+	pCursor->Offset = Offset + Align(RINGLOG_RECORD_SIZE + Entry.Length);
+	pCursor->Left--;
+
+	return true;
+}
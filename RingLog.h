@@ -0,0 +1,99 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RINGLOG_H
+#define RINGLOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed size circular log kept in a memory mapped file, all integers little
+// endian:
+//
+//   Header   "AT3R", u16 Version, u16 HeaderSize, u64 Size, u64 Head,
+//            u64 Tail, u64 Records, u64 Sequence
+//   Record   u32 Length, u8 Type, u8 Port, u16 Reserved, u64 Sequence,
+//            u64 RealtimeNs, Length bytes, padded to 8 bytes
+//
+// Records live in the Size bytes after the header, the oldest one at Tail and
+// the next one goes at Head. A record never straddles the end, a WRAP record
+// or less than a record header of room left sends the walk back to offset 0.
+// Appends are a memcpy into the mapping that overwrites the oldest records as
+// needed, the header is only updated once the new record is in place. The
+// log carries on from Head when it is opened again.
+enum {
+	RINGLOG_LINE = 0,
+	RINGLOG_FRAME = 1,
+	RINGLOG_WRAP = 2,
+};
+
+enum {
+	RINGLOG_MIN_SIZE = 1024 * 1024,
+	RINGLOG_MAX_RECORD = 64 * 1024,
+	// RINGLOG_Poll() pushes the dirty pages to disk that often
+	RINGLOG_SYNC_MS = 5000,
+};
+
+typedef struct RingLog_t RingLog_t;
+
+typedef struct RingLogRecord_t {
+	uint64_t Sequence;
+	uint64_t Realtime;
+	const uint8_t *pData;
+	uint32_t Length;
+	uint8_t Type;
+	uint8_t Port;
+} RingLogRecord_t;
+
+typedef struct RingLogCursor_t {
+	uint64_t Offset;
+	uint64_t Left;
+} RingLogCursor_t;
+
+typedef struct RingLogStats_t {
+	uint64_t Size;
+	uint64_t Records;
+	uint64_t Appended;
+	uint64_t Overwritten;
+	uint64_t Wraps;
+	uint64_t Syncs;
+	// Realtime of the oldest record kept and of the last one appended since
+	// the log was opened, 0 when there is none
+	uint64_t Oldest;
+	uint64_t Newest;
+} RingLogStats_t;
+
+// Opens an existing ring log as it is, whatever its size, or creates one of
+// Size bytes with the disk space reserved up front. Refuses any other file.
+RingLog_t *RINGLOG_Open(const char *pPath, uint64_t Size);
+void RINGLOG_Close(RingLog_t *pLog);
+// Syncs, then maps the path again, which creates a new log if it was moved
+bool RINGLOG_Reopen(RingLog_t *pLog);
+
+bool RINGLOG_Append(RingLog_t *pLog, uint8_t Type, uint8_t Port, uint64_t Realtime, const void *pData, size_t Length);
+// Syncs the dirty pages once RINGLOG_SYNC_MS went by since the last time
+void RINGLOG_Poll(RingLog_t *pLog, uint64_t Now);
+bool RINGLOG_Sync(RingLog_t *pLog);
+
+void RINGLOG_GetStats(const RingLog_t *pLog, RingLogStats_t *pStats);
+
+// Reading walks a mapped copy of the file, oldest record first
+bool RINGLOG_IsRingLog(const uint8_t *pData, size_t Length);
+void RINGLOG_Rewind(const uint8_t *pData, RingLogCursor_t *pCursor);
+bool RINGLOG_Next(const uint8_t *pData, size_t Length, RingLogCursor_t *pCursor, RingLogRecord_t *pRecord);
+
+#endif
@@ -0,0 +1,297 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "BitStream.h"
+#include "Helpers.h"
+#include "Site.h"
+
+enum {
+	SITE_BCAST_CHAN_FREQ = 5,
+	SITE_BCAST_ADJACENT = 6,
+	SITE_MBC_CONTINUATION = 5,
+	// Grants to a channel given in full in an MBC block rather than by LPCN
+	SITE_LPCN_ABSOLUTE = 0xFFF,
+};
+
+struct Site_t {
+	bool bCode;
+	uint16_t Code;
+	// Timeslot plus one of a Chan_Freq announcement waiting for its MBC block
+	uint8_t PendingTs;
+	size_t AdjacentCount;
+	uint16_t Adjacent[SITE_MAX_ADJACENT];
+	// Known channels are kept dense, in the order they were first heard
+	size_t Count;
+	uint16_t Index[SITE_MAX_LPCN];
+	SiteChannel_t Channels[SITE_MAX_LPCN];
+};
+
+// Private
+
+static SiteChannel_t *GetChannel(Site_t *pSite, uint16_t Lpcn)
+{
+	Lpcn &= SITE_MAX_LPCN - 1;
+	if (!pSite->Index[Lpcn]) {
+		SiteChannel_t *pChannel = &pSite->Channels[pSite->Count++];
+
+		pChannel->Lpcn = Lpcn;
+		pSite->Index[Lpcn] = (uint16_t)pSite->Count;
+	}
+
+	return &pSite->Channels[pSite->Index[Lpcn] - 1];
+}
+
+static void AddAdjacent(Site_t *pSite, uint16_t Code)
+{
+	size_t i;
+
+	for (i = 0; i < pSite->AdjacentCount; i++) {
+		if (pSite->Adjacent[i] == Code) {
+			return;
+		}
+	}
+	if (pSite->AdjacentCount < SITE_MAX_ADJACENT) {
+		pSite->Adjacent[pSite->AdjacentCount++] = Code;
+	}
+}
+
+// CH_PARMS block following a Chan_Freq announcement: LPCN, then the transmit
+// and receive frequencies as whole MHz plus 125 Hz steps. Bursts carry a
+// length byte before the block, as CSBKs do.
+static void AddChannelPlan(Site_t *pSite, const uint8_t *pData, size_t Length)
+{
+	SiteChannel_t *pChannel;
+	BitStream_t Bs;
+	uint32_t TxMhz, TxStep, RxMhz, RxStep;
+	uint16_t Lpcn;
+
+	if (Length < 11) {
+		return;
+	}
+	BS_Init(&Bs, pData + 1, 10);
+	BS_SkipBits(&Bs, 20);
+	Lpcn = (uint16_t)BS_ExtractBits(&Bs, 12);
+	TxMhz = (uint32_t)BS_ExtractBits(&Bs, 10);
+	TxStep = (uint32_t)BS_ExtractBits(&Bs, 13);
+	RxMhz = (uint32_t)BS_ExtractBits(&Bs, 10);
+	RxStep = (uint32_t)BS_ExtractBits(&Bs, 13);
+	if (Lpcn == SITE_LPCN_ABSOLUTE) {
+		return;
+	}
+
+	pChannel = GetChannel(pSite, Lpcn);
+	pChannel->TxHz = TxMhz * 1000000U + TxStep * 125U;
+	pChannel->RxHz = RxMhz * 1000000U + RxStep * 125U;
+}
+
+static void AddGrant(Site_t *pSite, const Event_t *pEvent, uint64_t Realtime)
+{
+	SiteSlot_t *pSlot;
+
+	if (pEvent->Grant.Channel == SITE_LPCN_ABSOLUTE) {
+		return;
+	}
+
+	pSlot = &GetChannel(pSite, pEvent->Grant.Channel)->Slots[(pEvent->Grant.Slot - 1) & 1];
+	pSlot->Granted = Realtime;
+	pSlot->bGranted = true;
+	pSlot->Source = pEvent->Grant.Source;
+	pSlot->Target = pEvent->Grant.Target;
+	pSlot->bPrivate = pEvent->Type == EVENT_PV_GRANT;
+	pSlot->bEmergency = pEvent->Grant.bEmergency;
+}
+
+static bool IsBusy(const SiteSlot_t *pSlot, uint64_t Now)
+{
+	if (!pSlot->bGranted) {
+		return false;
+	}
+	// Without time a grant is all there is to go by
+	if (!Now || !pSlot->Granted) {
+		return true;
+	}
+
+	return Now < pSlot->Granted + SITE_HOLD_MS * 1000000ULL;
+}
+
+static void FormatFrequency(uint32_t Hz, char *pText, size_t TextLength)
+{
+	if (Hz) {
+		sprintf_s(pText, TextLength, "%u.%06u", Hz / 1000000U, Hz % 1000000U);
+	} else {
+		sprintf_s(pText, TextLength, "?");
+	}
+}
+
+// Public
+
+Site_t *SITE_New(void)
+{
+	return (Site_t *)calloc(1, sizeof(Site_t));
+}
+
+void SITE_Free(Site_t *pSite)
+{
+	free(pSite);
+}
+
+void SITE_Add(Site_t *pSite, const Event_t *pEvent, uint64_t Realtime)
+{
+	const uint8_t PendingTs = pSite->PendingTs;
+
+	if (pEvent->Flags & EVENT_INCOMPLETE) {
+		return;
+	}
+
+	// The MBC block has to follow its header on the same timeslot
+	if (pEvent->Ts + 1 == PendingTs) {
+		pSite->PendingTs = 0;
+	}
+
+	switch (pEvent->Type) {
+	case EVENT_ALOHA:
+		pSite->bCode = true;
+		pSite->Code = pEvent->Aloha.Code;
+		break;
+
+	case EVENT_C_BCAST:
+		pSite->bCode = true;
+		pSite->Code = pEvent->Bcast.Code;
+		if (pEvent->Bcast.Kind == SITE_BCAST_CHAN_FREQ) {
+			pSite->PendingTs = pEvent->Ts + 1;
+		} else if (pEvent->Bcast.Kind == SITE_BCAST_ADJACENT) {
+			// The adjacent system code leads the second parameter
+			AddAdjacent(pSite, (uint16_t)(pEvent->Bcast.Params2 >> 8));
+		}
+		break;
+
+	case EVENT_PV_GRANT:
+	case EVENT_TV_GRANT:
+	case EVENT_BTV_GRANT:
+		AddGrant(pSite, pEvent, Realtime);
+		break;
+
+	case EVENT_BURST:
+		if (pEvent->DataType == SITE_MBC_CONTINUATION && pEvent->Ts + 1 == PendingTs) {
+			AddChannelPlan(pSite, pEvent->pData, pEvent->Length);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+bool SITE_GetCode(const Site_t *pSite, uint16_t *pCode)
+{
+	*pCode = pSite->Code;
+
+	return pSite->bCode;
+}
+
+bool SITE_GetFrequency(const Site_t *pSite, uint16_t Lpcn, uint32_t *pTxHz, uint32_t *pRxHz)
+{
+	const SiteChannel_t *pChannel;
+
+	Lpcn &= SITE_MAX_LPCN - 1;
+	if (!pSite->Index[Lpcn]) {
+		return false;
+	}
+	pChannel = &pSite->Channels[pSite->Index[Lpcn] - 1];
+	*pTxHz = pChannel->TxHz;
+	*pRxHz = pChannel->RxHz;
+
+	return pChannel->TxHz != 0;
+}
+
+size_t SITE_GetAdjacent(const Site_t *pSite, uint16_t *pCodes, size_t Count)
+{
+	if (Count > pSite->AdjacentCount) {
+		Count = pSite->AdjacentCount;
+	}
+	memcpy(pCodes, pSite->Adjacent, Count * sizeof(pCodes[0]));
+
+	return Count;
+}
+
+size_t SITE_Snapshot(const Site_t *pSite, uint64_t Now, SiteChannel_t *pChannels, size_t Count)
+{
+	size_t i;
+
+	if (Count > pSite->Count) {
+		Count = pSite->Count;
+	}
+	for (i = 0; i < Count; i++) {
+		pChannels[i] = pSite->Channels[i];
+		pChannels[i].Slots[0].bBusy = IsBusy(&pChannels[i].Slots[0], Now);
+		pChannels[i].Slots[1].bBusy = IsBusy(&pChannels[i].Slots[1], Now);
+	}
+
+	return Count;
+}
+
+size_t SITE_FormatSite(const Site_t *pSite, const SiteChannel_t *pChannels, size_t Count, char *pText, size_t TextLength)
+{
+	char Code[16];
+	size_t Busy = 0;
+	size_t i;
+
+	for (i = 0; i < Count; i++) {
+		Busy += pChannels[i].Slots[0].bBusy + pChannels[i].Slots[1].bBusy;
+	}
+	if (pSite->bCode) {
+		sprintf_s(Code, sizeof(Code), "0x%04X", pSite->Code);
+	} else {
+		sprintf_s(Code, sizeof(Code), "?");
+	}
+	sprintf_s(pText, TextLength, "Site %s: %zu channels, %zu of %zu timeslots busy", Code, Count, Busy, Count * 2);
+	if (pSite->AdjacentCount) {
+		strcat_s(pText, TextLength, ", adjacent");
+		for (i = 0; i < pSite->AdjacentCount; i++) {
+			sprintf_s(Code, sizeof(Code), " 0x%04X", pSite->Adjacent[i]);
+			strcat_s(pText, TextLength, Code);
+		}
+	}
+
+	return strlen(pText);
+}
+
+size_t SITE_FormatChannel(const SiteChannel_t *pChannel, char *pText, size_t TextLength)
+{
+	char Tx[16], Rx[16], Slot[64];
+	size_t i;
+
+	FormatFrequency(pChannel->TxHz, Tx, sizeof(Tx));
+	FormatFrequency(pChannel->RxHz, Rx, sizeof(Rx));
+	sprintf_s(pText, TextLength, "  LPCN %4u  %s/%s MHz", pChannel->Lpcn, Tx, Rx);
+	for (i = 0; i < 2; i++) {
+		const SiteSlot_t *pSlot = &pChannel->Slots[i];
+
+		if (pSlot->bBusy) {
+			sprintf_s(Slot, sizeof(Slot), "  TS%zu %s%s %u -> %u", i + 1,
+				pSlot->bEmergency ? "Emergency " : "", pSlot->bPrivate ? "Private" : "Group",
+				pSlot->Source, pSlot->Target);
+		} else {
+			sprintf_s(Slot, sizeof(Slot), "  TS%zu idle", i + 1);
+		}
+		strcat_s(pText, TextLength, Slot);
+	}
+
+	return strlen(pText);
+}
@@ -0,0 +1,72 @@
+/* Copyright 2026 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef SITE_H
+#define SITE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Event.h"
+
+// Tier III site as seen from its control channel: the system code from
+// C_BCAST and ALOHA, the logical channel (LPCN) to frequency plan and the
+// adjacent sites from C_BCAST, and which payload timeslots are in use from
+// the voice grants. Everything is updated one event at a time.
+enum {
+	SITE_MAX_LPCN = 4096,
+	SITE_MAX_ADJACENT = 16,
+	SITE_HOLD_MS = 3000, // A timeslot stays busy this long after its last grant
+};
+
+typedef struct SiteSlot_t {
+	uint64_t Granted; // Realtime of the last grant
+	uint32_t Source;
+	uint32_t Target;
+	bool bGranted;
+	bool bBusy;       // Only filled in by SITE_Snapshot()
+	bool bPrivate;
+	bool bEmergency;
+} SiteSlot_t;
+
+typedef struct SiteChannel_t {
+	uint32_t TxHz; // 0 until the plan is announced
+	uint32_t RxHz;
+	uint16_t Lpcn;
+	SiteSlot_t Slots[2];
+} SiteChannel_t;
+
+typedef struct Site_t Site_t;
+
+Site_t *SITE_New(void);
+void SITE_Free(Site_t *pSite);
+
+// Realtime is 0 for raw captures, grants then keep their timeslot busy
+void SITE_Add(Site_t *pSite, const Event_t *pEvent, uint64_t Realtime);
+
+bool SITE_GetCode(const Site_t *pSite, uint16_t *pCode);
+bool SITE_GetFrequency(const Site_t *pSite, uint16_t Lpcn, uint32_t *pTxHz, uint32_t *pRxHz);
+size_t SITE_GetAdjacent(const Site_t *pSite, uint16_t *pCodes, size_t Count);
+// Copies up to Count known channels with their busy timeslots as of Now. Runs
+// in O(channels) and returns how many were copied.
+size_t SITE_Snapshot(const Site_t *pSite, uint64_t Now, SiteChannel_t *pChannels, size_t Count);
+
+// One line for the site and one per channel of a snapshot, without newlines
+size_t SITE_FormatSite(const Site_t *pSite, const SiteChannel_t *pChannels, size_t Count, char *pText, size_t TextLength);
+size_t SITE_FormatChannel(const SiteChannel_t *pChannel, char *pText, size_t TextLength);
+
+#endif